@@ -0,0 +1,91 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "/root/repo/CMakeLists.txt.in"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "googletest-src/CMakeLists.txt"
+  "googletest-src/googlemock/CMakeLists.txt"
+  "googletest-src/googlemock/cmake/gmock.pc.in"
+  "googletest-src/googlemock/cmake/gmock_main.pc.in"
+  "googletest-src/googletest/CMakeLists.txt"
+  "googletest-src/googletest/cmake/Config.cmake.in"
+  "googletest-src/googletest/cmake/gtest.pc.in"
+  "googletest-src/googletest/cmake/gtest_main.pc.in"
+  "googletest-src/googletest/cmake/internal_utils.cmake"
+  "/root/repo/cpp-frp/CMakeLists.txt"
+  "/root/repo/test/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/BasicConfigVersion-AnyNewerVersion.cmake.in"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeDependentOption.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakePackageConfigHelpers.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython/Support.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/GNUInstallDirs.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  "/usr/share/cmake-3.25/Modules/WriteBasicConfigVersionFile.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "googletest-download/CMakeLists.txt"
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "googletest-build/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "googletest-build/googletest/generated/gmock.pc"
+  "googletest-build/googletest/generated/gmock_main.pc"
+  "googletest-build/googlemock/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "googletest-build/googletest/generated/GTestConfigVersion.cmake"
+  "googletest-build/googletest/generated/GTestConfig.cmake"
+  "googletest-build/googletest/generated/gtest.pc"
+  "googletest-build/googletest/generated/gtest_main.pc"
+  "googletest-build/googletest/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "cpp-frp/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "googletest-build/googlemock/CMakeFiles/gmock.dir/DependInfo.cmake"
+  "googletest-build/googlemock/CMakeFiles/gmock_main.dir/DependInfo.cmake"
+  "googletest-build/googletest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  "googletest-build/googletest/CMakeFiles/gtest_main.dir/DependInfo.cmake"
+  "cpp-frp/CMakeFiles/cpp-frp.dir/DependInfo.cmake"
+  "test/CMakeFiles/frp-test.dir/DependInfo.cmake"
+  "test/CMakeFiles/frp-instrumentation-test.dir/DependInfo.cmake"
+  )
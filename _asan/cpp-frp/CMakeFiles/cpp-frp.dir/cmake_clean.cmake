@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/cpp-frp.dir/src/dummy.cpp.o"
+  "CMakeFiles/cpp-frp.dir/src/dummy.cpp.o.d"
+  "libcpp-frp.a"
+  "libcpp-frp.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/cpp-frp.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
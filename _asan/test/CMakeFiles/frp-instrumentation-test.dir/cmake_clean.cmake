@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/frp-instrumentation-test.dir/src/instrumentation-test.cpp.o"
+  "CMakeFiles/frp-instrumentation-test.dir/src/instrumentation-test.cpp.o.d"
+  "frp-instrumentation-test"
+  "frp-instrumentation-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/frp-instrumentation-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,48 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/test/src/cancellation-test.cpp" "test/CMakeFiles/frp-test.dir/src/cancellation-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/cancellation-test.cpp.o.d"
+  "/root/repo/test/src/collector-test.cpp" "test/CMakeFiles/frp-test.dir/src/collector-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/collector-test.cpp.o.d"
+  "/root/repo/test/src/demand-test.cpp" "test/CMakeFiles/frp-test.dir/src/demand-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/demand-test.cpp.o.d"
+  "/root/repo/test/src/example-test.cpp" "test/CMakeFiles/frp-test.dir/src/example-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/example-test.cpp.o.d"
+  "/root/repo/test/src/filter-test.cpp" "test/CMakeFiles/frp-test.dir/src/filter-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/filter-test.cpp.o.d"
+  "/root/repo/test/src/group_by-test.cpp" "test/CMakeFiles/frp-test.dir/src/group_by-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/group_by-test.cpp.o.d"
+  "/root/repo/test/src/instrumentation-test.cpp" "test/CMakeFiles/frp-test.dir/src/instrumentation-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/instrumentation-test.cpp.o.d"
+  "/root/repo/test/src/join-test.cpp" "test/CMakeFiles/frp-test.dir/src/join-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/join-test.cpp.o.d"
+  "/root/repo/test/src/list-test.cpp" "test/CMakeFiles/frp-test.dir/src/list-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/list-test.cpp.o.d"
+  "/root/repo/test/src/map-test.cpp" "test/CMakeFiles/frp-test.dir/src/map-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/map-test.cpp.o.d"
+  "/root/repo/test/src/map_cache-test.cpp" "test/CMakeFiles/frp-test.dir/src/map_cache-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/map_cache-test.cpp.o.d"
+  "/root/repo/test/src/numa_thread_pool-test.cpp" "test/CMakeFiles/frp-test.dir/src/numa_thread_pool-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/numa_thread_pool-test.cpp.o.d"
+  "/root/repo/test/src/pipeline-test.cpp" "test/CMakeFiles/frp-test.dir/src/pipeline-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/pipeline-test.cpp.o.d"
+  "/root/repo/test/src/priority_thread_pool-test.cpp" "test/CMakeFiles/frp-test.dir/src/priority_thread_pool-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/priority_thread_pool-test.cpp.o.d"
+  "/root/repo/test/src/project-test.cpp" "test/CMakeFiles/frp-test.dir/src/project-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/project-test.cpp.o.d"
+  "/root/repo/test/src/pull-test.cpp" "test/CMakeFiles/frp-test.dir/src/pull-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/pull-test.cpp.o.d"
+  "/root/repo/test/src/sample-test.cpp" "test/CMakeFiles/frp-test.dir/src/sample-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/sample-test.cpp.o.d"
+  "/root/repo/test/src/sort-test.cpp" "test/CMakeFiles/frp-test.dir/src/sort-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/sort-test.cpp.o.d"
+  "/root/repo/test/src/source-sink-test.cpp" "test/CMakeFiles/frp-test.dir/src/source-sink-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/source-sink-test.cpp.o.d"
+  "/root/repo/test/src/static_graph-test.cpp" "test/CMakeFiles/frp-test.dir/src/static_graph-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/static_graph-test.cpp.o.d"
+  "/root/repo/test/src/stream_source-test.cpp" "test/CMakeFiles/frp-test.dir/src/stream_source-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/stream_source-test.cpp.o.d"
+  "/root/repo/test/src/subscribe-test.cpp" "test/CMakeFiles/frp-test.dir/src/subscribe-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/subscribe-test.cpp.o.d"
+  "/root/repo/test/src/threading-test.cpp" "test/CMakeFiles/frp-test.dir/src/threading-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/threading-test.cpp.o.d"
+  "/root/repo/test/src/throttle-test.cpp" "test/CMakeFiles/frp-test.dir/src/throttle-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/throttle-test.cpp.o.d"
+  "/root/repo/test/src/transform-test.cpp" "test/CMakeFiles/frp-test.dir/src/transform-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/transform-test.cpp.o.d"
+  "/root/repo/test/src/transform_n-test.cpp" "test/CMakeFiles/frp-test.dir/src/transform_n-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/transform_n-test.cpp.o.d"
+  "/root/repo/test/src/vector-test.cpp" "test/CMakeFiles/frp-test.dir/src/vector-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/vector-test.cpp.o.d"
+  "/root/repo/test/src/window-test.cpp" "test/CMakeFiles/frp-test.dir/src/window-test.cpp.o" "gcc" "test/CMakeFiles/frp-test.dir/src/window-test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_asan/googletest-build/googletest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  "/root/repo/_asan/googletest-build/googletest/CMakeFiles/gtest_main.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,65 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/frp-test.dir/src/cancellation-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/cancellation-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/collector-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/collector-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/demand-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/demand-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/example-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/example-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/filter-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/filter-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/group_by-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/group_by-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/instrumentation-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/instrumentation-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/join-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/join-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/list-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/list-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/map-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/map-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/map_cache-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/map_cache-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/numa_thread_pool-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/numa_thread_pool-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/pipeline-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/pipeline-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/priority_thread_pool-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/priority_thread_pool-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/project-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/project-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/pull-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/pull-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/sample-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/sample-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/sort-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/sort-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/source-sink-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/source-sink-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/static_graph-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/static_graph-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/stream_source-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/stream_source-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/subscribe-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/subscribe-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/threading-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/threading-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/throttle-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/throttle-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/transform-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/transform-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/transform_n-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/transform_n-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/vector-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/vector-test.cpp.o.d"
+  "CMakeFiles/frp-test.dir/src/window-test.cpp.o"
+  "CMakeFiles/frp-test.dir/src/window-test.cpp.o.d"
+  "frp-test"
+  "frp-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/frp-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
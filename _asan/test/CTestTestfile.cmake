@@ -0,0 +1,10 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_asan/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(UnitTests "frp-test")
+set_tests_properties(UnitTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;61;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(InstrumentationTests "frp-instrumentation-test")
+set_tests_properties(InstrumentationTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;76;add_test;/root/repo/test/CMakeLists.txt;0;")
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_CANCELLATION_H_
+#define _FRP_CANCELLATION_H_
+
+#include <atomic>
+#include <frp/instrumentation.h>
+#include <memory>
+
+namespace frp {
+namespace util {
+
+typedef std::atomic_size_t generation_type;
+
+// Identifies one evaluation of a repository. It is cancelled as soon as the repository starts
+// another evaluation, since that one will see newer revisions of the dependencies.
+struct cancellation_type {
+	cancellation_type() : generation(0), evaluation() {}
+
+	cancellation_type(const std::shared_ptr<generation_type> &current, std::size_t generation,
+		const instrumentation_type::start_type &evaluation = {})
+		: current(current), generation(generation), evaluation(evaluation) {}
+
+	bool cancelled() const {
+		return current && current->load(std::memory_order_relaxed) != generation;
+	}
+
+	const instrumentation_type::start_type &get_evaluation() const {
+		return evaluation;
+	}
+
+private:
+	std::shared_ptr<const generation_type> current;
+	std::size_t generation;
+	instrumentation_type::start_type evaluation;
+};
+
+inline cancellation_type next_cancellation(const std::shared_ptr<generation_type> &current,
+		const instrumentation_type::start_type &evaluation = {}) {
+	return cancellation_type(current, current->fetch_add(1, std::memory_order_relaxed) + 1,
+		evaluation);
+}
+
+// Makes cancellation visible to the user functions invoked on this thread while in scope.
+struct cancellation_scope_type {
+	explicit cancellation_scope_type(const cancellation_type &cancellation)
+		: previous(current()), task(cancellation.get_evaluation()) {
+		current() = &cancellation;
+	}
+
+	cancellation_scope_type(const cancellation_scope_type &) = delete;
+
+	~cancellation_scope_type() {
+		current() = previous;
+	}
+
+	static const cancellation_type *&current() {
+		thread_local const cancellation_type *cancellation(nullptr);
+		return cancellation;
+	}
+
+private:
+	const cancellation_type *previous;
+	instrumentation_type::task_type task;
+};
+
+} // namespace util
+
+// Lets long running functions give up early. True if the evaluation which invoked the calling
+// function has been superseded by a newer one, its result would then be discarded anyway.
+inline bool cancelled() {
+	auto cancellation(util::cancellation_scope_type::current());
+	return cancellation && cancellation->cancelled();
+}
+
+} // namespace frp
+
+#endif // _FRP_CANCELLATION_H_
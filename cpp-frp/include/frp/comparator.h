@@ -0,0 +1,46 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_COMPARATOR_H_
+#define _FRP_COMPARATOR_H_
+
+#include <functional>
+#include <type_traits>
+
+namespace frp {
+
+// Comparator treating every new value as a change. Recognized at compile time by the
+// operators, which then skip comparing values altogether.
+struct never_equal {
+	template<typename T>
+	constexpr bool operator()(const T &, const T &) const {
+		return false;
+	}
+};
+
+namespace util {
+
+template<typename Comparator>
+struct is_never_equal : std::false_type {};
+
+template<>
+struct is_never_equal<never_equal> : std::true_type {};
+
+// Comparator for collections of elements compared with Comparator.
+template<typename Comparator, typename Collection>
+using collection_comparator_t = std::conditional_t<is_never_equal<Comparator>::value,
+	never_equal, std::equal_to<Collection>>;
+
+} // namespace util
+} // namespace frp
+
+#endif // _FRP_COMPARATOR_H_
@@ -13,6 +13,9 @@
 #ifndef _FRP_EXECUTE_ON_H_
 #define _FRP_EXECUTE_ON_H_
 
+#include <deque>
+#include <functional>
+#include <type_traits>
 #include <utility>
 
 namespace frp {
@@ -27,10 +30,56 @@ struct execute_on_type {
 	F function;
 };
 
+// Tasks submitted to the immediate executor while another one is running on the same thread
+// are queued and run by the outermost call once it returns. Propagation through long chains
+// of repositories then uses constant stack depth instead of several frames per node.
+struct trampoline_type {
+	typedef std::function<void()> task_type;
+
+	static trampoline_type &current() {
+		thread_local trampoline_type trampoline;
+		return trampoline;
+	}
+
+	template<typename F>
+	void operator()(F &&f) {
+		if (active) {
+			tasks.emplace_back(std::forward<F>(f));
+		} else {
+			guard_type guard(*this);
+			f();
+			while (!tasks.empty()) {
+				auto task(std::move(tasks.front()));
+				tasks.pop_front();
+				task();
+			}
+		}
+	}
+
+private:
+	// Pending tasks are dropped if one of them throws, the exception reaches the outermost
+	// caller just like it would have without the trampoline.
+	struct guard_type {
+		explicit guard_type(trampoline_type &trampoline) : trampoline(trampoline) {
+			trampoline.active = true;
+		}
+
+		~guard_type() {
+			trampoline.tasks.clear();
+			trampoline.active = false;
+		}
+
+		trampoline_type &trampoline;
+	};
+
+	bool active = false;
+	std::deque<task_type> tasks;
+};
+
 struct execute_immediate_type {
 	template<typename F>
 	void operator()(F f) const {
-		f();
+		trampoline_type::current()(std::move(f));
 	}
 };
 
@@ -78,6 +127,51 @@ decltype(auto) get_function(F &&f) {
 	return from_function_type<F>::function(std::forward<F>(f));
 }
 
+// Executors declaring index_type also accept the index of an element task and the number of
+// elements, which lets them keep neighbouring elements, and the memory written for them,
+// on the same node.
+template<typename E, typename = void>
+struct is_indexed_executor : std::false_type {};
+
+template<typename E>
+struct is_indexed_executor<E, decltype(void(std::declval<typename E::index_type>()))>
+	: std::true_type {};
+
+template<typename E, typename F>
+std::enable_if_t<is_indexed_executor<E>::value> execute_indexed(const E &executor, F &&f,
+		std::size_t index, std::size_t count) {
+	executor(std::forward<F>(f), index, count);
+}
+
+template<typename E, typename F>
+std::enable_if_t<!is_indexed_executor<E>::value> execute_indexed(const E &executor, F &&f,
+		std::size_t, std::size_t) {
+	executor(std::forward<F>(f));
+}
+
+// Runs tasks on the calling thread if it already is a worker of the executor, see
+// inline_if_on. Element tasks are always submitted so that they still run in parallel.
+template<typename E>
+struct inline_if_on_type {
+	typedef std::size_t index_type;
+
+	template<typename F>
+	void operator()(F &&f) const {
+		if (executor.on_worker()) {
+			trampoline_type::current()(std::forward<F>(f));
+		} else {
+			executor(std::forward<F>(f));
+		}
+	}
+
+	template<typename F>
+	void operator()(F &&f, std::size_t index, std::size_t count) const {
+		execute_indexed(executor, std::forward<F>(f), index, count);
+	}
+
+	E executor;
+};
+
 } // namespace internal
 
 template<typename E, typename F>
@@ -85,6 +179,14 @@ internal::execute_on_type<F, E> execute_on(E executor, F function) {
 	return { std::forward<E>(executor), std::forward<F>(function) };
 }
 
+// Adapts an executor providing on_worker(), such as those of priority_thread_pool_type and
+// numa_thread_pool_type, to continue on the thread which committed the dependency instead of
+// submitting another task. Saves a queue hop and a cache migration per node of a pipeline.
+template<typename E>
+internal::inline_if_on_type<E> inline_if_on(E executor) {
+	return { std::forward<E>(executor) };
+}
+
 } // namespace frp
 
 #endif // _FRP_EXECUTE_ON_H_
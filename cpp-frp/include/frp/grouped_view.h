@@ -0,0 +1,131 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_GROUPED_VIEW_H_
+#define _FRP_GROUPED_VIEW_H_
+
+#include <algorithm>
+#include <frp/vector_view.h>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace frp {
+
+// Groups of values sharing a key. The values of all groups are stored contiguously, group
+// by group, and every group refers to its range of them. Groups are iterable, so operators
+// such as map can be applied per group, and found by key in constant time.
+template<typename K, typename V, typename Comparator = std::equal_to<V>,
+	typename Hash = std::hash<K>>
+struct grouped_view_type {
+	typedef vector_view_type<V, Comparator> values_type;
+	typedef std::unordered_map<K, std::size_t, Hash> index_type;
+
+	struct group_type {
+		typedef V value_type;
+		typedef typename values_type::const_iterator const_iterator;
+
+		const K &key() const {
+			return group_key;
+		}
+
+		const_iterator begin() const {
+			return first;
+		}
+
+		const_iterator end() const {
+			return last;
+		}
+
+		std::size_t size() const {
+			return last - first;
+		}
+
+		const V &operator[](std::size_t index) const {
+			return first[index];
+		}
+
+		bool operator==(const group_type &group) const {
+			return group_key == group.group_key
+				&& std::equal(first, last, group.first, group.last, Comparator());
+		}
+
+		K group_key;
+		const_iterator first;
+		const_iterator last;
+	};
+
+	typedef group_type value_type;
+	typedef typename std::vector<group_type>::const_iterator const_iterator;
+
+	// offsets holds the key and the offset of the first value of every group in order.
+	grouped_view_type(values_type &&values, std::vector<std::pair<K, std::size_t>> &&offsets,
+			index_type &&index)
+		: grouped_values(std::move(values)), index(std::move(index)) {
+		groups.reserve(offsets.size());
+		for (std::size_t i = 0; i < offsets.size(); ++i) {
+			groups.push_back(group_type{ std::move(offsets[i].first),
+				grouped_values.begin() + offsets[i].second, i + 1 < offsets.size()
+					? grouped_values.begin() + offsets[i + 1].second : grouped_values.end() });
+		}
+	}
+
+	grouped_view_type(grouped_view_type &&) = default;
+	grouped_view_type &operator=(grouped_view_type &&) = default;
+	grouped_view_type(const grouped_view_type &) = delete;
+	grouped_view_type &operator=(const grouped_view_type &) = delete;
+
+	const_iterator begin() const {
+		return groups.begin();
+	}
+
+	const_iterator end() const {
+		return groups.end();
+	}
+
+	std::size_t size() const {
+		return groups.size();
+	}
+
+	bool empty() const {
+		return groups.empty();
+	}
+
+	const group_type &operator[](std::size_t index) const {
+		return groups[index];
+	}
+
+	// The group of key, or end() if there is none.
+	const_iterator find(const K &key) const {
+		auto it(index.find(key));
+		return it == index.end() ? end() : begin() + it->second;
+	}
+
+	const values_type &values() const {
+		return grouped_values;
+	}
+
+	// Every value belongs to a group, comparing the groups compares all of them.
+	bool operator==(const grouped_view_type &view) const {
+		return groups == view.groups;
+	}
+
+private:
+	values_type grouped_values;
+	std::vector<group_type> groups;
+	index_type index;
+};
+
+} // namespace frp
+
+#endif // _FRP_GROUPED_VIEW_H_
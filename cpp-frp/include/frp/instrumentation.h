@@ -0,0 +1,369 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_INSTRUMENTATION_H_
+#define _FRP_INSTRUMENTATION_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <frp/util/storage.h>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#ifdef FRP_ENABLE_INSTRUMENTATION
+#include <frp/trace.h>
+#endif
+
+namespace frp {
+namespace instrumentation {
+
+typedef std::chrono::steady_clock clock_type;
+
+// Evaluation wall times in buckets of powers of two nanoseconds. Bucket i counts durations in
+// [2^i, 2^(i+1)) nanoseconds, bucket 0 also counts shorter ones.
+struct histogram_type {
+	static constexpr std::size_t buckets = 64;
+
+	histogram_type() : sum(0) {
+		for (auto &count : counts) {
+			count.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void record(clock_type::duration duration) {
+		auto nanoseconds(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+		sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+		std::size_t bucket(0);
+		while (nanoseconds > 1) {
+			nanoseconds >>= 1;
+			++bucket;
+		}
+		counts[bucket].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	uint64_t count(std::size_t bucket) const {
+		return counts[bucket].load(std::memory_order_relaxed);
+	}
+
+	uint64_t total() const {
+		uint64_t total(0);
+		for (const auto &count : counts) {
+			total += count.load(std::memory_order_relaxed);
+		}
+		return total;
+	}
+
+	std::chrono::nanoseconds mean() const {
+		auto total(this->total());
+		return std::chrono::nanoseconds(total ? sum.load(std::memory_order_relaxed) / total : 0);
+	}
+
+private:
+	std::array<std::atomic<uint64_t>, buckets> counts;
+	std::atomic<uint64_t> sum;
+};
+
+namespace details {
+
+template<typename T, typename = void>
+struct is_container : std::false_type {};
+
+template<typename T>
+struct is_container<T, decltype(std::declval<const T &>().size(), void(
+	sizeof(typename T::value_type)))> : std::true_type {};
+
+template<typename T>
+std::size_t value_size(const T &, std::false_type) {
+	return sizeof(T);
+}
+
+template<typename T>
+std::size_t value_size(const T &value, std::true_type) {
+	return sizeof(T) + value.size() * sizeof(typename T::value_type);
+}
+
+} // namespace details
+
+// Shallow estimate of the memory held by a value, containers count their elements but not
+// what the elements point to.
+template<typename T>
+std::size_t value_size(const T &value) {
+	return details::value_size(value, details::is_container<T>());
+}
+
+template<typename T>
+std::size_t storage_size(const util::storage_type<T> &storage) {
+	return value_size(storage.value);
+}
+
+inline std::size_t storage_size(const util::storage_type<void> &) {
+	return 0;
+}
+
+struct node_statistics_type {
+	typedef uint64_t id_type;
+
+	node_statistics_type(id_type id, const std::string &type,
+		std::vector<id_type> &&dependencies)
+		: id(id), type(type), dependencies(std::move(dependencies)), evaluations(0), commits(0)
+		, rejected(0), suppressed(0), revision(util::default_revision), size(0) {}
+
+	const id_type id;
+	// Implementation defined name of the value type.
+	const std::string type;
+	const std::vector<id_type> dependencies;
+	// Generator invocations, each one evaluates the node for the current dependency revisions.
+	std::atomic<uint64_t> evaluations;
+	// Results which replaced the previous value and were propagated.
+	std::atomic<uint64_t> commits;
+	// Results discarded since a result for newer dependency revisions was already committed.
+	std::atomic<uint64_t> rejected;
+	// Results which replaced the previous value without propagating, as the comparator found
+	// them equal.
+	std::atomic<uint64_t> suppressed;
+	// Time from the start of an evaluation until its result was submitted.
+	histogram_type latency;
+	// Revision and value_size() of the current value.
+	std::atomic<util::revision_type> revision;
+	std::atomic<std::size_t> size;
+};
+
+// Every instrumented repository alive in the process.
+struct registry_type {
+	typedef std::shared_ptr<node_statistics_type> node_type;
+	typedef std::vector<std::shared_ptr<const node_statistics_type>> snapshot_type;
+
+	template<typename T>
+	node_type make_node(std::vector<node_statistics_type::id_type> &&dependencies) {
+		auto node(std::make_shared<node_statistics_type>(++next_id, typeid(T).name(),
+			std::move(dependencies)));
+		std::lock_guard<std::mutex> lock(mutex);
+		prune();
+		nodes.push_back(node);
+		return node;
+	}
+
+	snapshot_type snapshot() {
+		snapshot_type snapshot;
+		std::lock_guard<std::mutex> lock(mutex);
+		prune();
+		for (const auto &node : nodes) {
+			if (auto locked = node.lock()) {
+				snapshot.push_back(locked);
+			}
+		}
+		return snapshot;
+	}
+
+private:
+	void prune() {
+		nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](const auto &node) {
+			return node.expired();
+		}), nodes.end());
+	}
+
+	std::atomic<node_statistics_type::id_type> next_id{ 0 };
+	std::mutex mutex;
+	std::vector<std::weak_ptr<node_statistics_type>> nodes;
+};
+
+inline registry_type &registry() {
+	static registry_type registry;
+	return registry;
+}
+
+// Ids of the nodes in the snapshot which depend on the given one.
+inline std::vector<node_statistics_type::id_type> dependents(
+		const registry_type::snapshot_type &snapshot, node_statistics_type::id_type id) {
+	std::vector<node_statistics_type::id_type> dependents;
+	for (const auto &node : snapshot) {
+		if (std::find(node->dependencies.begin(), node->dependencies.end(), id)
+				!= node->dependencies.end()) {
+			dependents.push_back(node->id);
+		}
+	}
+	return dependents;
+}
+
+namespace details {
+
+inline void write_escaped(std::ostream &stream, const std::string &value) {
+	for (auto c : value) {
+		if (c == '"' || c == '\\') {
+			stream << '\\';
+		}
+		stream << c;
+	}
+}
+
+} // namespace details
+
+// Graphviz digraph with an edge from every dependency to its dependent.
+inline std::ostream &write_dot(std::ostream &stream,
+		const registry_type::snapshot_type &snapshot = registry().snapshot()) {
+	stream << "digraph frp {\n";
+	for (const auto &node : snapshot) {
+		stream << "\tn" << node->id << " [label=\"";
+		details::write_escaped(stream, node->type);
+		stream << "\\nrevision " << node->revision << ", " << node->size << " bytes\\n"
+			<< node->evaluations << " evaluations, " << node->latency.mean().count()
+			<< " ns mean\"];\n";
+		for (auto dependency : node->dependencies) {
+			stream << "\tn" << dependency << " -> n" << node->id << ";\n";
+		}
+	}
+	return stream << "}\n";
+}
+
+inline std::ostream &write_json(std::ostream &stream,
+		const registry_type::snapshot_type &snapshot = registry().snapshot()) {
+	stream << "{\"nodes\":[";
+	for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+		const auto &node(**it);
+		stream << (it == snapshot.begin() ? "" : ",") << "{\"id\":" << node.id
+			<< ",\"type\":\"";
+		details::write_escaped(stream, node.type);
+		stream << "\",\"dependencies\":[";
+		for (auto dependency = node.dependencies.begin(); dependency != node.dependencies.end();
+				++dependency) {
+			stream << (dependency == node.dependencies.begin() ? "" : ",") << *dependency;
+		}
+		stream << "],\"revision\":" << node.revision << ",\"size\":" << node.size
+			<< ",\"evaluations\":" << node.evaluations << ",\"commits\":" << node.commits
+			<< ",\"rejected\":" << node.rejected << ",\"suppressed\":" << node.suppressed
+			<< ",\"mean_ns\":" << node.latency.mean().count() << "}";
+	}
+	return stream << "]}\n";
+}
+
+constexpr bool enabled() {
+#ifdef FRP_ENABLE_INSTRUMENTATION
+	return true;
+#else
+	return false;
+#endif
+}
+
+} // namespace instrumentation
+
+namespace util {
+
+#ifdef FRP_ENABLE_INSTRUMENTATION
+
+// Held by every repository and bound into its evaluations.
+struct instrumentation_type {
+	// Identifies one evaluation of the node, carried to its tasks by the cancellation token.
+	struct start_type {
+		instrumentation::clock_type::time_point time;
+		uint64_t node;
+		uint64_t evaluation;
+	};
+
+	// Traces a task of an evaluation on the calling thread while in scope.
+	struct task_type : trace::span_type {
+		explicit task_type(const start_type &start)
+			: trace::span_type("evaluate", start.node, start.evaluation) {}
+	};
+
+	// Nodes are registered after their dependencies, sources and stream sources included.
+	template<typename T, typename... Dependencies>
+	static instrumentation_type make(const Dependencies &... dependencies) {
+		return { instrumentation::registry().make_node<T>({ dependencies.node->id... }) };
+	}
+
+	start_type evaluation_started() const {
+		return { instrumentation::clock_type::now(), node->id,
+			node->evaluations.fetch_add(1, std::memory_order_relaxed) };
+	}
+
+	// A source was assigned or modified.
+	template<typename Storage>
+	void written(start_type start, const Storage &storage) const {
+		node->commits.fetch_add(1, std::memory_order_relaxed);
+		finished("write", start, storage);
+	}
+
+	template<typename Storage>
+	void committed(start_type start, const Storage &storage) const {
+		node->commits.fetch_add(1, std::memory_order_relaxed);
+		finished("commit", start, storage);
+	}
+
+	void rejected(start_type start) const {
+		node->rejected.fetch_add(1, std::memory_order_relaxed);
+		trace::instant("reject", start.node, start.evaluation, util::default_revision);
+		finished(start);
+	}
+
+	template<typename Storage>
+	void suppressed(start_type start, const Storage &storage) const {
+		node->suppressed.fetch_add(1, std::memory_order_relaxed);
+		finished("suppress", start, storage);
+	}
+
+	std::shared_ptr<instrumentation::node_statistics_type> node;
+
+private:
+	void finished(start_type start) const {
+		node->latency.record(instrumentation::clock_type::now() - start.time);
+	}
+
+	template<typename Storage>
+	void finished(const char *name, start_type start, const Storage &storage) const {
+		trace::instant(name, start.node, start.evaluation, storage.revision);
+		node->revision.store(storage.revision, std::memory_order_relaxed);
+		node->size.store(instrumentation::storage_size(storage), std::memory_order_relaxed);
+		finished(start);
+	}
+};
+
+#else
+
+// Empty unless FRP_ENABLE_INSTRUMENTATION is defined, every call then compiles away.
+struct instrumentation_type {
+	struct start_type {};
+
+	struct task_type {
+		explicit task_type(const start_type &) {}
+	};
+
+	template<typename T, typename... Dependencies>
+	static instrumentation_type make(const Dependencies &...) {
+		return {};
+	}
+
+	start_type evaluation_started() const {
+		return {};
+	}
+
+	template<typename Storage>
+	void written(start_type, const Storage &) const {}
+	template<typename Storage>
+	void committed(start_type, const Storage &) const {}
+	void rejected(start_type) const {}
+	template<typename Storage>
+	void suppressed(start_type, const Storage &) const {}
+};
+
+#endif
+
+} // namespace util
+} // namespace frp
+
+#endif // _FRP_INSTRUMENTATION_H_
@@ -13,7 +13,9 @@
 #ifndef _FRP_INTERNAL_NAMESPACE_ALIAS_H_
 #define _FRP_INTERNAL_NAMESPACE_ALIAS_H_
 
+namespace frp { namespace stat { namespace pull {} } }
 namespace frp { namespace stat { namespace push {} } }
+namespace fspl = frp::stat::pull;
 namespace fsp = frp::stat::push;
 
 #endif // _FRP_INTERNAL_NAMESPACE_ALIAS_H_
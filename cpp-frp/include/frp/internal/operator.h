@@ -21,6 +21,11 @@ auto get_storage(T &value)->decltype(value.get_storage()) {
 	return value.get_storage();
 }
 
+template<typename T>
+auto get_instrumentation(T &value)->decltype(value.get_instrumentation()) {
+	return value.get_instrumentation();
+}
+
 } // namespace details
 } // namespace frp
 
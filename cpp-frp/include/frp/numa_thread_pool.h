@@ -0,0 +1,293 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_NUMA_THREAD_POOL_H_
+#define _FRP_NUMA_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace frp {
+
+// CPUs grouped by NUMA node. A node without CPUs still gets a worker, which is then not
+// pinned, this is how a topology can be simulated on a machine with a single node.
+struct numa_topology_type {
+	typedef std::vector<unsigned> cpus_type;
+
+	std::vector<cpus_type> nodes;
+
+	// Reads /sys/devices/system/node, or reports a single node with every CPU if unavailable.
+	// Node ids need not be contiguous, and nodes with memory only are left out.
+	static numa_topology_type detect() {
+		numa_topology_type topology;
+		std::string list;
+		if (read_line("/sys/devices/system/node/has_cpu", list)
+				|| read_line("/sys/devices/system/node/online", list)) {
+			for (auto node : parse_cpulist(list)) {
+				if (read_line("/sys/devices/system/node/node" + std::to_string(node)
+						+ "/cpulist", list)) {
+					auto cpus(parse_cpulist(list));
+					if (!cpus.empty()) {
+						topology.nodes.push_back(cpus);
+					}
+				}
+			}
+		}
+		if (topology.nodes.empty()) {
+			cpus_type cpus;
+			for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency());
+					++cpu) {
+				cpus.push_back(cpu);
+			}
+			topology.nodes.push_back(cpus);
+		}
+		return topology;
+	}
+
+	static numa_topology_type fake(std::size_t nodes) {
+		return { std::vector<cpus_type>(nodes) };
+	}
+
+	// Reads the first line of path, returns false if it cannot be opened.
+	static bool read_line(const std::string &path, std::string &line) {
+		std::ifstream file(path);
+		if (!file) {
+			return false;
+		}
+		line.clear();
+		std::getline(file, line);
+		return true;
+	}
+
+	// Parses the kernel list format, for instance "0-3,8-11", of CPUs as well as nodes.
+	static cpus_type parse_cpulist(const std::string &list) {
+		cpus_type cpus;
+		std::istringstream stream(list);
+		std::string range;
+		while (std::getline(stream, range, ',')) {
+			if (range.empty()) {
+				continue;
+			}
+			auto separator(range.find('-'));
+			unsigned first(std::stoul(range.substr(0, separator)));
+			unsigned last(separator == std::string::npos ? first
+				: std::stoul(range.substr(separator + 1)));
+			for (unsigned cpu = first; cpu <= last; ++cpu) {
+				cpus.push_back(cpu);
+			}
+		}
+		return cpus;
+	}
+};
+
+// Thread pool with one queue and a set of pinned workers per NUMA node. Element tasks of map
+// are partitioned by index, so each node constructs, and thereby first touches, one
+// contiguous range of the output, which places those pages on the node reading them next.
+struct numa_thread_pool_type {
+	typedef std::function<void()> task_type;
+	typedef std::size_t node_type;
+
+	enum : node_type { no_node = node_type(-1) };
+
+private:
+	struct instance_type;
+
+	struct queue_type {
+		std::deque<task_type> tasks;
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+
+	struct worker_type {
+		const instance_type *instance;
+		node_type node;
+	};
+
+	static worker_type &current_worker() {
+		thread_local worker_type worker{ nullptr, no_node };
+		return worker;
+	}
+
+	struct instance_type {
+		instance_type(const numa_topology_type &topology, std::size_t threads_per_node)
+			: queues(std::max<std::size_t>(1, topology.nodes.size()))
+			, next(0)
+			, outstanding(0)
+			, running(true) {
+			for (node_type node = 0; node < queues.size(); ++node) {
+				auto cpus(node < topology.nodes.size() ? topology.nodes[node]
+					: numa_topology_type::cpus_type());
+				auto threads(threads_per_node ? threads_per_node
+					: std::max<std::size_t>(1, cpus.size()));
+				for (std::size_t index = 0; index < threads; ++index) {
+					this->threads.emplace_back([this, node, cpus]() {
+						pin(cpus);
+						current_worker() = { this, node };
+						work(queues[node]);
+					});
+				}
+			}
+		}
+
+		~instance_type() {
+			running = false;
+			for (auto &queue : queues) {
+				{
+					std::lock_guard<std::mutex> lock(queue.mutex);
+				}
+				queue.condition.notify_all();
+			}
+			for (auto &thread : threads) {
+				thread.join();
+			}
+		}
+
+		void submit(node_type node, task_type &&task) {
+			auto &queue(queues[node]);
+			outstanding.fetch_add(1);
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				queue.tasks.push_back(std::move(task));
+			}
+			queue.condition.notify_one();
+		}
+
+		// Stays on the node of the calling worker, spreads tasks from other threads.
+		node_type local_node() {
+			auto &worker(current_worker());
+			return worker.instance == this ? worker.node : next++ % queues.size();
+		}
+
+		void wait_idle() {
+			std::unique_lock<std::mutex> lock(idle_mutex);
+			idle_condition.wait(lock, [this]() { return !outstanding.load(); });
+		}
+
+		void work(queue_type &queue) {
+			for (;;) {
+				task_type task;
+				{
+					std::unique_lock<std::mutex> lock(queue.mutex);
+					queue.condition.wait(lock, [&]() { return !queue.tasks.empty() || !running; });
+					if (!running) {
+						break;
+					}
+					task = std::move(queue.tasks.front());
+					queue.tasks.pop_front();
+				}
+				task();
+				task = nullptr;
+				if (outstanding.fetch_sub(1) == 1) {
+					{
+						std::lock_guard<std::mutex> lock(idle_mutex);
+					}
+					idle_condition.notify_all();
+				}
+			}
+		}
+
+		static void pin(const numa_topology_type::cpus_type &cpus) {
+#ifdef __linux__
+			if (!cpus.empty()) {
+				cpu_set_t set;
+				CPU_ZERO(&set);
+				for (auto cpu : cpus) {
+					CPU_SET(cpu, &set);
+				}
+				// Best effort, the worker stays unpinned if the CPUs are not available to us.
+				pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+			}
+#endif
+		}
+
+		std::vector<queue_type> queues;
+		std::atomic_size_t next;
+		std::atomic_size_t outstanding;
+		std::atomic_bool running;
+		std::mutex idle_mutex;
+		std::condition_variable idle_condition;
+		std::vector<std::thread> threads;
+	};
+
+public:
+	// The pool must outlive the executor.
+	struct executor_type {
+		friend struct numa_thread_pool_type;
+
+		typedef std::size_t index_type;
+
+		void operator()(task_type &&task) const {
+			instance->submit(instance->local_node(), std::move(task));
+		}
+
+		// Element index of count runs on the node owning that part of the range.
+		void operator()(task_type &&task, index_type index, std::size_t count) const {
+			assert(index < count);
+			instance->submit(index * instance->queues.size() / count, std::move(task));
+		}
+
+		bool on_worker() const {
+			return current_worker().instance == instance;
+		}
+
+	private:
+		explicit executor_type(instance_type *instance) : instance(instance) {}
+
+		instance_type *instance;
+	};
+
+	// Zero threads per node means one per CPU of the node.
+	explicit numa_thread_pool_type(const numa_topology_type &topology
+			= numa_topology_type::detect(), std::size_t threads_per_node = 0)
+		: instance(std::make_unique<instance_type>(topology, threads_per_node)) {}
+
+	executor_type executor() const {
+		return executor_type(instance.get());
+	}
+
+	std::size_t nodes() const {
+		return instance->queues.size();
+	}
+
+	// Blocks until no task is queued or running.
+	void wait_idle() const {
+		instance->wait_idle();
+	}
+
+	// The node of the calling thread if it is a worker of this pool, no_node otherwise.
+	node_type current_node() const {
+		auto &worker(current_worker());
+		return worker.instance == instance.get() ? worker.node : no_node;
+	}
+
+private:
+	std::unique_ptr<instance_type> instance;
+};
+
+} // namespace frp
+
+#endif // _FRP_NUMA_THREAD_POOL_H_
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_PRIORITY_THREAD_POOL_H_
+#define _FRP_PRIORITY_THREAD_POOL_H_
+
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace frp {
+
+// Thread pool with one queue per priority level. Workers always pick the oldest task of the
+// most urgent non-empty level, level 0 being the most urgent. Running tasks are never
+// preempted, but a burst of element tasks of a map on a low level can no longer delay tasks
+// submitted on a higher level behind them.
+struct priority_thread_pool_type {
+	typedef std::function<void()> task_type;
+	typedef std::size_t priority_type;
+
+	struct executor_type;
+
+private:
+	struct instance_type {
+		instance_type(std::size_t threads, std::size_t levels)
+			: queues(levels), pending(0), active(0), running(true) {
+			assert(levels > 0);
+			for (std::size_t index = 0; index < threads; ++index) {
+				this->threads.emplace_back([this]() {
+					current() = this;
+					work();
+				});
+			}
+		}
+
+		~instance_type() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				running = false;
+			}
+			tasks_condition.notify_all();
+			for (auto &thread : threads) {
+				thread.join();
+			}
+		}
+
+		void submit(priority_type priority, task_type &&task) {
+			assert(priority < queues.size());
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				queues[priority].push(std::move(task));
+				++pending;
+			}
+			tasks_condition.notify_one();
+		}
+
+		void wait_idle() {
+			std::unique_lock<std::mutex> lock(mutex);
+			idle_condition.wait(lock, [this]() { return !pending && !active; });
+		}
+
+		void work() {
+			std::unique_lock<std::mutex> lock(mutex);
+			for (;;) {
+				tasks_condition.wait(lock, [this]() { return pending || !running; });
+				if (!running) {
+					break;
+				}
+				auto task(pop());
+				++active;
+				lock.unlock();
+				task();
+				task = nullptr;
+				lock.lock();
+				if (!--active && !pending) {
+					idle_condition.notify_all();
+				}
+			}
+		}
+
+		// The pool the calling thread is a worker of, if any.
+		static const instance_type *&current() {
+			thread_local const instance_type *instance(nullptr);
+			return instance;
+		}
+
+		task_type pop() {
+			for (auto &queue : queues) {
+				if (!queue.empty()) {
+					auto task(std::move(queue.front()));
+					queue.pop();
+					--pending;
+					return task;
+				}
+			}
+			assert(false);
+			return task_type();
+		}
+
+		std::vector<std::queue<task_type>> queues;
+		std::size_t pending;
+		std::size_t active;
+		bool running;
+		std::mutex mutex;
+		std::condition_variable tasks_condition;
+		std::condition_variable idle_condition;
+		std::vector<std::thread> threads;
+	};
+
+public:
+	// Submits tasks on a fixed priority level. Hand it to execute_on, the element tasks of
+	// map and filter then inherit the level of their repository. The pool must outlive it.
+	struct executor_type {
+		friend struct priority_thread_pool_type;
+
+		void operator()(task_type &&task) const {
+			instance->submit(priority, std::move(task));
+		}
+
+		bool on_worker() const {
+			return instance_type::current() == instance;
+		}
+
+	private:
+		executor_type(instance_type *instance, priority_type priority)
+			: instance(instance), priority(priority) {}
+
+		instance_type *instance;
+		priority_type priority;
+	};
+
+	priority_thread_pool_type(std::size_t threads, std::size_t levels)
+		: instance(std::make_unique<instance_type>(threads, levels)) {}
+
+	executor_type priority(priority_type priority) const {
+		assert(priority < levels());
+		return executor_type(instance.get(), priority);
+	}
+
+	std::size_t levels() const {
+		return instance->queues.size();
+	}
+
+	// Blocks until every queue is empty and no task is running.
+	void wait_idle() const {
+		instance->wait_idle();
+	}
+
+private:
+	std::unique_ptr<instance_type> instance;
+};
+
+} // namespace frp
+
+#endif // _FRP_PRIORITY_THREAD_POOL_H_
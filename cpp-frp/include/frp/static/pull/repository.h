@@ -0,0 +1,194 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PULL_REPOSITORY_H_
+#define _FRP_STATIC_PULL_REPOSITORY_H_
+
+#include <atomic>
+#include <frp/comparator.h>
+#include <frp/execute_on.h>
+#include <frp/instrumentation.h>
+#include <frp/internal/namespace_alias.h>
+#include <frp/internal/operator.h>
+#include <frp/util/function.h>
+#include <frp/util/observable.h>
+#include <frp/util/observe_all.h>
+#include <frp/util/reference.h>
+#include <frp/util/storage.h>
+#include <frp/util/variadic.h>
+#include <frp/util/vector.h>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace frp {
+namespace stat {
+namespace pull {
+
+template<typename T>
+struct repository_type;
+
+namespace details {
+
+template<typename T>
+struct node_type {
+	virtual std::shared_ptr<util::storage_type<T>> get() = 0;
+	virtual ~node_type() {}
+
+	util::observable_type observable;
+	util::instrumentation_type instrumentation;
+};
+
+// Changes upstream only mark the node dirty, and dependents transitively. The value is
+// recomputed once it is read and the revisions of the dependencies differ from the ones it was
+// last computed from.
+template<typename T, typename Storage, typename Comparator, typename Generator,
+	typename... Dependencies>
+struct template_node_type : node_type<T> {
+	typedef typename Storage::revisions_type revisions_type;
+
+	template_node_type(Generator &&generator, Dependencies &&... dependencies)
+		: generator(std::forward<Generator>(generator))
+		, dependencies(std::forward<Dependencies>(dependencies)...)
+		, dirty(true) {
+		node_type<T>::instrumentation = util::invoke([](const auto&... dependencies) {
+			return util::instrumentation_type::make<T>(
+				internal::get_instrumentation(util::unwrap_container(dependencies))...);
+		}, this->dependencies);
+	}
+
+	void invalidate() {
+		if (!dirty.exchange(true)) {
+			node_type<T>::observable.update();
+		}
+	}
+
+	std::shared_ptr<util::storage_type<T>> get() override final {
+		if (!dirty.exchange(false)) {
+			return std::atomic_load(&storage);
+		}
+		auto values(util::invoke([](const auto&... dependencies) {
+			return std::make_tuple(internal::get_storage(util::unwrap_container(dependencies))...);
+		}, dependencies));
+		bool available(util::invoke([](const auto&... values) {
+			return util::all_true(values...);
+		}, values));
+		auto current(std::atomic_load(&storage));
+		if (!available) {
+			return current;
+		}
+		auto revisions(util::invoke([](const auto&... values) {
+			return revisions_type{ values->revision... };
+		}, values));
+		if (current && current->revisions == revisions) {
+			return current;
+		}
+		const auto &instrumentation(node_type<T>::instrumentation);
+		auto start(instrumentation.evaluation_started());
+		auto commit(std::make_shared<Storage>(generator(values), util::default_revision,
+			revisions));
+		bool equals;
+		do {
+			if (current && !current->is_newer(revisions)) {
+				instrumentation.rejected(start);
+				return current;
+			}
+			equals = current && !util::is_never_equal<Comparator>::value
+				&& current->compare_value(*commit, comparator);
+			commit->revision = !current ? util::default_revision + 1
+				: equals ? current->revision : current->revision + 1;
+		} while (!std::atomic_compare_exchange_weak(&storage, &current, commit));
+		if (equals) {
+			instrumentation.suppressed(start, *commit);
+		} else {
+			instrumentation.committed(start, *commit);
+		}
+		return commit;
+	}
+
+	Generator generator;
+	std::tuple<Dependencies...> dependencies;
+	std::vector<util::observable_type::reference_type> callbacks;
+	std::shared_ptr<Storage> storage; // Use atomics!
+	std::atomic_bool dirty;
+	Comparator comparator;
+};
+
+template<typename T, typename Storage, typename Comparator, typename Generator,
+	typename... Dependencies>
+repository_type<T> make_repository(Generator &&generator, Dependencies &&... dependencies);
+
+} // namespace details
+
+template<typename T>
+struct repository_type {
+
+	template<typename U, typename Storage, typename Comparator, typename Generator,
+		typename... Dependencies>
+	friend repository_type<U> details::make_repository(Generator &&generator,
+		Dependencies &&... dependencies);
+	template<typename O, typename F>
+	friend auto util::add_callback(O &observable, F &&f)
+		->decltype(observable.add_callback(std::forward<F>(f)));
+	template<typename U>
+	friend auto internal::get_storage(U &value)->decltype(value.get_storage());
+	template<typename U>
+	friend auto internal::get_instrumentation(U &value)->decltype(value.get_instrumentation());
+
+	typedef T value_type;
+
+	repository_type() = default;
+
+private:
+	explicit repository_type(const std::shared_ptr<details::node_type<T>> &node) : node(node) {}
+
+	auto get_storage() const {
+		return node->get();
+	}
+
+	const auto &get_instrumentation() const {
+		return node->instrumentation;
+	}
+
+	template<typename F>
+	auto add_callback(F &&f) const {
+		return node->observable.add_callback(std::forward<F>(f));
+	}
+
+	std::shared_ptr<details::node_type<T>> node;
+};
+
+namespace details {
+
+template<typename T, typename Storage, typename Comparator, typename Generator,
+	typename... Dependencies>
+repository_type<T> make_repository(Generator &&generator, Dependencies &&... dependencies) {
+	typedef template_node_type<T, Storage, Comparator, Generator, Dependencies...> node_type;
+	auto node(std::make_shared<node_type>(std::forward<Generator>(generator),
+		std::forward<Dependencies>(dependencies)...));
+	node->callbacks = util::vector_from_array(util::invoke(util::observe_all(
+		[weak_node = std::weak_ptr<node_type>(node)]() {
+			auto node(weak_node.lock());
+			if (node) {
+				node->invalidate();
+			}
+		}), std::ref(node->dependencies)));
+	return repository_type<T>(node);
+}
+
+} // namespace details
+
+} // namespace pull
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PULL_REPOSITORY_H_
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PULL_SOURCE_H_
+#define _FRP_STATIC_PULL_SOURCE_H_
+
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/source.h>
+
+namespace frp {
+namespace stat {
+namespace pull {
+
+// Sources never compute anything, the push source already stores its value and notifies
+// dependents which in pull mode merely invalidates them.
+using push::source_type;
+using push::source;
+
+} // namespace pull
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PULL_SOURCE_H_
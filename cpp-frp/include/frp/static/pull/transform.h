@@ -0,0 +1,55 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PULL_TRANSFORM_H_
+#define _FRP_STATIC_PULL_TRANSFORM_H_
+
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/pull/repository.h>
+
+namespace frp {
+namespace stat {
+namespace pull {
+
+template<typename Comparator, typename Function, typename... Dependencies>
+auto transform(Function &&function, Dependencies... dependencies) {
+	static_assert(util::all_true_type<typename util::is_not_void<
+		typename util::unwrap_container_t<Dependencies>::value_type>::type...>::value,
+		"Dependencies can not be void type.");
+
+	typedef util::transform_return_type<Function, Dependencies...> value_type;
+	static_assert(!std::is_void<value_type>::value,
+		"T must not be void type, nothing would ever read the result.");
+	typedef util::commit_storage_type<value_type, sizeof...(Dependencies)> commit_storage_type;
+
+	return details::make_repository<value_type, commit_storage_type, Comparator>(
+		[function = internal::get_function(
+			util::unwrap_reference(std::forward<Function>(function)))](
+			const auto &values) {
+		return util::invoke([&](const auto&... values) {
+			return function(values->value...);
+		}, values);
+	}, std::forward<Dependencies>(dependencies)...);
+}
+
+template<typename Function, typename... Dependencies>
+auto transform(Function &&function, Dependencies... dependencies) {
+	typedef util::transform_return_type<Function, Dependencies...> value_type;
+	return pull::transform<std::equal_to<value_type>, Function, Dependencies...>(
+		std::forward<Function>(function), std::forward<Dependencies>(dependencies)...);
+}
+
+} // namespace pull
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PULL_TRANSFORM_H_
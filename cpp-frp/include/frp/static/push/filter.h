@@ -13,6 +13,8 @@
 #ifndef _FRP_STATIC_PUSH_FILTER_H_
 #define _FRP_STATIC_PUSH_FILTER_H_
 
+#include <frp/cancellation.h>
+#include <frp/comparator.h>
 #include <frp/internal/namespace_alias.h>
 #include <frp/static/push/repository.h>
 #include <frp/util/collector.h>
@@ -36,10 +38,11 @@ auto filter(Function &&function, Dependencies&&... dependencies) {
 		commit_storage_type;
 	typedef std::array<util::revision_type, sizeof...(Dependencies)> revisions_type;
 	return details::make_repository<collector_view_type, commit_storage_type,
-		std::equal_to<collector_view_type>>([
+		util::collection_comparator_t<Comparator, collector_view_type>>([
 			function = internal::get_function(util::unwrap_reference(std::forward<Function>(function))),
 			executor = internal::get_executor(util::unwrap_reference(std::forward<Function>(function)))](
-				auto &&callback, const auto &, const auto &dependencies) {
+				auto &&callback, const auto &, const auto &dependencies,
+				const auto &cancellation) {
 			typedef util::append_collector_type<value_type, Comparator> collector_type;
 
 			auto values(util::invoke([&](const auto&... dependency) {
@@ -54,18 +57,25 @@ auto filter(Function &&function, Dependencies&&... dependencies) {
 					collector_view_type(collector_type(0)), util::default_revision, revisions));
 			} else {
 				auto collector(std::make_shared<collector_type>(collection.size()));
+				std::size_t counter(0);
 				for (const auto &value : collection) {
-					executor([function, collector, &value, callback, values, revisions]() {
-						auto complete(util::indexed_invoke_with_replacement<I>(std::move(function),
-							std::cref(value), util::invoke([&](const auto&... values) {
-								return std::tie(values->value...);
-							}, values)));
-						if (complete ? collector->construct(std::ref(value)) : collector->skip()) {
+					internal::execute_indexed(executor, [function, collector, &value, callback,
+							values, revisions, cancellation]() {
+						util::cancellation_scope_type scope(cancellation);
+						auto complete(!cancellation.cancelled()
+							&& util::indexed_invoke_with_replacement<I>(std::move(function),
+								std::cref(value), util::invoke([&](const auto&... values) {
+									return std::tie(values->value...);
+								}, values)));
+						// Skipped elements are indistinguishable from rejected ones, so the
+						// collection is only committed if no element was skipped.
+						if ((complete ? collector->construct(std::ref(value)) : collector->skip())
+								&& !cancellation.cancelled()) {
 							callback(std::make_shared<commit_storage_type>(
 								collector_view_type(std::move(*collector)), util::default_revision,
 								revisions));
 						}
-					});
+					}, counter++, collection.size());
 				}
 			}
 		}, std::forward<Dependencies>(dependencies)...);
@@ -77,19 +87,19 @@ auto filter(Function &&function, Dependencies&&... dependencies) {
 		::value_type::value_type value_type;
 	static_assert(util::is_equality_comparable<value_type>::value,
 		"T must implement equality comparator");
-	return filter<I, std::equal_to<value_type>>(std::forward<Function>(function),
+	return push::filter<I, std::equal_to<value_type>>(std::forward<Function>(function),
 		std::forward<Dependencies>(dependencies)...);
 }
 
 template<typename Comparator, typename Function, typename Dependency>
 auto filter(Function &&function, Dependency &&dependency) {
-	return filter<0, Comparator>(std::forward<Function>(function),
+	return push::filter<0, Comparator>(std::forward<Function>(function),
 		std::forward<Dependency>(dependency));
 }
 
 template<typename Function, typename Dependency>
 auto filter(Function &&function, Dependency &&dependency) {
-	return filter<0>(std::forward<Function>(function),
+	return push::filter<0>(std::forward<Function>(function),
 		std::forward<Dependency>(dependency));
 }
 
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_GROUP_BY_H_
+#define _FRP_STATIC_PUSH_GROUP_BY_H_
+
+#include <algorithm>
+#include <atomic>
+#include <frp/cancellation.h>
+#include <frp/comparator.h>
+#include <frp/grouped_view.h>
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/repository.h>
+#include <frp/util/collector.h>
+#include <unordered_map>
+#include <vector>
+
+namespace frp {
+namespace stat {
+namespace push {
+namespace details {
+
+// Inputs smaller than a grain are partitioned by a single task.
+constexpr std::size_t group_by_grain_size = 1 << 12;
+constexpr std::size_t group_by_max_chunks = 64;
+
+// Groups of one chunk of the input, in order of first occurrence.
+template<typename K, typename V, typename Hash>
+struct group_by_chunk_type {
+	std::unordered_map<K, std::size_t, Hash> index;
+	std::vector<K> keys;
+	std::vector<std::vector<const V *>> members;
+	std::vector<std::size_t> offsets; // Of every group in the output, set once merged.
+};
+
+template<typename K, typename V, typename Hash>
+struct group_by_state_type {
+	explicit group_by_state_type(std::size_t count) : chunks(count), pending(count) {}
+
+	std::vector<group_by_chunk_type<K, V, Hash>> chunks;
+	std::vector<std::pair<K, std::size_t>> offsets;
+	std::unordered_map<K, std::size_t, Hash> index;
+	std::atomic_size_t pending;
+};
+
+// Merges the groups of every chunk, in chunk order, and assigns each group of each chunk its
+// range of the output. Groups and their values hence keep the order of the input.
+template<typename K, typename V, typename Hash>
+void merge_groups(group_by_state_type<K, V, Hash> &state) {
+	std::vector<std::size_t> sizes;
+	for (auto &chunk : state.chunks) {
+		for (std::size_t group = 0; group < chunk.keys.size(); ++group) {
+			auto inserted(state.index.emplace(chunk.keys[group], sizes.size()));
+			if (inserted.second) {
+				state.offsets.emplace_back(chunk.keys[group], 0);
+				sizes.push_back(0);
+			}
+			chunk.offsets.push_back(inserted.first->second);
+			sizes[inserted.first->second] += chunk.members[group].size();
+		}
+	}
+	std::vector<std::size_t> cursors(sizes.size());
+	std::size_t offset(0);
+	for (std::size_t group = 0; group < sizes.size(); ++group) {
+		state.offsets[group].second = cursors[group] = offset;
+		offset += sizes[group];
+	}
+	for (auto &chunk : state.chunks) {
+		for (std::size_t group = 0; group < chunk.keys.size(); ++group) {
+			auto &cursor(cursors[chunk.offsets[group]]);
+			chunk.offsets[group] = cursor;
+			cursor += chunk.members[group].size();
+		}
+	}
+}
+
+} // namespace details
+
+// Groups the elements of the collection of dependency I by the key that function returns,
+// invoked like map. Chunks of the collection are partitioned into local groups in parallel,
+// merged, and then copied in parallel into a single array of values, see grouped_view_type.
+template<std::size_t I, typename Comparator, typename Hash, typename Function,
+	typename... Dependencies>
+auto group_by(Function &&function, Dependencies... dependencies) {
+	static_assert(I < sizeof...(Dependencies),
+		"expanded index must be in the range of [0, arity) where arity = number of dependencies.");
+	typedef typename util::unwrap_container_t<std::tuple_element_t<I, std::tuple<Dependencies...>>>
+		::value_type argument_container_type;
+	typedef std::decay_t<typename argument_container_type::value_type> value_type;
+	typedef std::decay_t<util::map_return_t<I, Function, Dependencies...>> key_type;
+	static_assert(std::is_copy_constructible<value_type>::value, "T must be copy constructible.");
+	static_assert(!std::is_void<key_type>::value, "Key must not be void type.");
+
+	typedef grouped_view_type<key_type, value_type, Comparator, Hash> view_type;
+	typedef util::commit_storage_type<view_type, sizeof...(Dependencies)> commit_storage_type;
+	typedef std::array<util::revision_type, sizeof...(Dependencies)> revisions_type;
+
+	return details::make_repository<view_type, commit_storage_type,
+			util::collection_comparator_t<Comparator, view_type>>([
+				function = internal::get_function(util::unwrap_reference(std::forward<Function>(function))),
+				executor = internal::get_executor(util::unwrap_reference(std::forward<Function>(function)))](
+				auto &&callback, const auto &, const auto &dependencies,
+				const auto &cancellation) {
+		typedef util::fixed_size_collector_type<value_type, Comparator> collector_type;
+		typedef details::group_by_state_type<key_type, value_type, Hash> state_type;
+
+		auto values(util::invoke([&](const auto&... dependency) {
+			return std::make_tuple(internal::get_storage(util::unwrap_container(dependency))...);
+		}, *dependencies));
+		auto revisions(util::invoke([&](const auto&... storage) {
+			return revisions_type{ storage->revision... };
+		}, values));
+		auto &collection(std::get<I>(values)->value);
+		std::size_t size(collection.size());
+		if (collection.empty()) {
+			callback(std::make_shared<commit_storage_type>(view_type(
+				typename view_type::values_type(collector_type(0)), {}, {}),
+				util::default_revision, revisions));
+			return;
+		}
+		std::size_t count(std::max<std::size_t>(1,
+			std::min(details::group_by_max_chunks, size / details::group_by_grain_size)));
+		auto state(std::make_shared<state_type>(count));
+		auto scatter([=](const std::shared_ptr<collector_type> &collector, std::size_t chunk) {
+			auto &local(state->chunks[chunk]);
+			bool complete(false);
+			for (std::size_t group = 0; group < local.keys.size(); ++group) {
+				std::size_t index(local.offsets[group]);
+				for (auto value : local.members[group]) {
+					complete = cancellation.cancelled() ? collector->skip(index++)
+						: collector->construct(index++, *value);
+				}
+			}
+			if (complete && collector->full()) {
+				callback(std::make_shared<commit_storage_type>(view_type(
+					typename view_type::values_type(std::move(*collector)),
+					std::move(state->offsets), std::move(state->index)),
+					util::default_revision, revisions));
+			}
+		});
+		for (std::size_t chunk = 0; chunk < count; ++chunk) {
+			internal::execute_indexed(executor, [=]() {
+				if (!cancellation.cancelled()) {
+					util::cancellation_scope_type scope(cancellation);
+					auto &collection(std::get<I>(values)->value);
+					auto &local(state->chunks[chunk]);
+					auto last(std::begin(collection) + (chunk + 1) * size / count);
+					for (auto it = std::begin(collection) + chunk * size / count; it != last;
+							++it) {
+						auto key(util::indexed_invoke_with_replacement<I>(function, std::cref(*it),
+							util::invoke([&](const auto&... values) {
+								return std::tie(values->value...);
+							}, values)));
+						auto inserted(local.index.emplace(key, local.keys.size()));
+						if (inserted.second) {
+							local.keys.push_back(std::move(key));
+							local.members.emplace_back();
+						}
+						local.members[inserted.first->second].push_back(&*it);
+					}
+				}
+				if (--state->pending == 0 && !cancellation.cancelled()) {
+					details::merge_groups(*state);
+					auto collector(std::make_shared<collector_type>(size));
+					for (std::size_t chunk = 0; chunk < count; ++chunk) {
+						internal::execute_indexed(executor, [scatter, collector, chunk]() {
+							scatter(collector, chunk);
+						}, chunk, count);
+					}
+				}
+			}, chunk, count);
+		}
+	}, std::forward<Dependencies>(dependencies)...);
+}
+
+template<std::size_t I, typename Hash, typename Function, typename... Dependencies>
+auto group_by(Function &&function, Dependencies... dependencies) {
+	typedef std::decay_t<typename util::unwrap_container_t<std::tuple_element_t<I,
+		std::tuple<Dependencies...>>>::value_type::value_type> value_type;
+	static_assert(util::is_equality_comparable<value_type>::value,
+		"T must implement equality comparator");
+	return push::group_by<I, std::equal_to<value_type>, Hash>(std::forward<Function>(function),
+		std::forward<Dependencies>(dependencies)...);
+}
+
+template<std::size_t I, typename Function, typename... Dependencies>
+auto group_by(Function &&function, Dependencies... dependencies) {
+	typedef std::decay_t<util::map_return_t<I, Function, Dependencies...>> key_type;
+	return push::group_by<I, std::hash<key_type>>(std::forward<Function>(function),
+		std::forward<Dependencies>(dependencies)...);
+}
+
+template<typename Comparator, typename Hash, typename Function, typename Dependency>
+auto group_by(Function &&function, Dependency dependency) {
+	return push::group_by<0, Comparator, Hash>(std::forward<Function>(function),
+		std::forward<Dependency>(dependency));
+}
+
+template<typename Hash, typename Function, typename Dependency>
+auto group_by(Function &&function, Dependency dependency) {
+	return push::group_by<0, Hash>(std::forward<Function>(function),
+		std::forward<Dependency>(dependency));
+}
+
+template<typename Function, typename Dependency>
+auto group_by(Function &&function, Dependency dependency) {
+	return push::group_by<0>(std::forward<Function>(function),
+		std::forward<Dependency>(dependency));
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_GROUP_BY_H_
@@ -0,0 +1,340 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_JOIN_H_
+#define _FRP_STATIC_PUSH_JOIN_H_
+
+#include <atomic>
+#include <cstdint>
+#include <frp/cancellation.h>
+#include <frp/comparator.h>
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/repository.h>
+#include <frp/util/collector.h>
+#include <frp/vector_view.h>
+#include <unordered_map>
+#include <vector>
+
+namespace frp {
+namespace stat {
+namespace push {
+namespace details {
+
+// Inputs smaller than a grain are processed by a single task per phase.
+constexpr std::size_t join_grain_size = 1 << 12;
+constexpr std::size_t join_max_chunks = 64;
+
+// A power of two, since it is also the number of partitions of the table.
+inline std::size_t join_chunks(std::size_t size) {
+	std::size_t count(1);
+	while (count < join_max_chunks && count * 2 * join_grain_size <= size) {
+		count *= 2;
+	}
+	return count;
+}
+
+// Hash table of the elements of the build side, split in partitions built independently.
+template<typename K, typename T, typename Input, typename Hash>
+struct join_table_type {
+	typedef K key_type;
+	typedef T value_type;
+	typedef std::unordered_map<K, std::vector<const T *>, Hash> partition_type;
+
+	join_table_type(const Input &input, std::size_t count) : input(input), partitions(count) {}
+
+	// Mixes the hash first, since partition_type uses its low bits as well.
+	std::size_t partition(const K &key) const {
+		return std::size_t((std::uint64_t(Hash()(key)) * 0x9E3779B97F4A7C15ull) >> 40)
+			& (partitions.size() - 1);
+	}
+
+	const std::vector<const T *> *find(const K &key) const {
+		const auto &partition(partitions[this->partition(key)]);
+		auto it(partition.find(key));
+		return it == partition.end() ? nullptr : &it->second;
+	}
+
+	Input input; // Keeps the elements alive.
+	std::vector<partition_type> partitions;
+};
+
+template<typename Container, typename TableA, typename TableB>
+struct join_commit_storage_type : util::commit_storage_type<Container, 2> {
+	typedef util::commit_storage_type<Container, 2> parent_type;
+	typedef typename parent_type::revisions_type revisions_type;
+
+	// The table built on the smaller side, reused as long as that side is unchanged.
+	std::shared_ptr<const TableA> table_a;
+	std::shared_ptr<const TableB> table_b;
+
+	join_commit_storage_type(Container &&value, util::revision_type revision,
+		const revisions_type &revisions, std::true_type,
+		const std::shared_ptr<const TableA> &table)
+		: parent_type(std::forward<Container>(value), revision, revisions), table_a(table) {}
+
+	join_commit_storage_type(Container &&value, util::revision_type revision,
+		const revisions_type &revisions, std::false_type,
+		const std::shared_ptr<const TableB> &table)
+		: parent_type(std::forward<Container>(value), revision, revisions), table_b(table) {}
+
+	const auto &table(std::true_type) const {
+		return table_a;
+	}
+
+	const auto &table(std::false_type) const {
+		return table_b;
+	}
+};
+
+// Chunks of the input are partitioned by key in parallel, then every partition of the table
+// is built by a task of its own. then(table) is invoked once the table is complete.
+template<typename Table, typename Executor, typename Key, typename Input, typename Cancellation,
+	typename Then>
+void build_join_table(const Executor &executor, const Key &key, const Input &input,
+		const Cancellation &cancellation, const Then &then) {
+	typedef typename Table::key_type key_type;
+	typedef typename Table::value_type value_type;
+	struct state_type {
+		state_type(const Input &input, std::size_t count)
+			: table(std::make_shared<Table>(input, count))
+			, rows(count, std::vector<std::vector<std::pair<key_type, const value_type *>>>(count))
+			, pending(count)
+			, building(count) {}
+
+		std::shared_ptr<Table> table;
+		// [chunk][partition]
+		std::vector<std::vector<std::vector<std::pair<key_type, const value_type *>>>> rows;
+		std::atomic_size_t pending;
+		std::atomic_size_t building;
+	};
+	std::size_t size(input->value.size()), count(join_chunks(size));
+	auto state(std::make_shared<state_type>(input, count));
+	for (std::size_t chunk = 0; chunk < count; ++chunk) {
+		internal::execute_indexed(executor, [=]() {
+			if (!cancellation.cancelled()) {
+				util::cancellation_scope_type scope(cancellation);
+				const auto &collection(input->value);
+				auto &row(state->rows[chunk]);
+				auto last(std::begin(collection) + (chunk + 1) * size / count);
+				for (auto it = std::begin(collection) + chunk * size / count; it != last; ++it) {
+					key_type value_key(key(*it));
+					auto partition(state->table->partition(value_key));
+					row[partition].emplace_back(std::move(value_key), &*it);
+				}
+			}
+			if (--state->pending == 0 && !cancellation.cancelled()) {
+				for (std::size_t partition = 0; partition < count; ++partition) {
+					internal::execute_indexed(executor, [=]() {
+						if (!cancellation.cancelled()) {
+							auto &table(state->table->partitions[partition]);
+							for (auto &row : state->rows) {
+								for (auto &entry : row[partition]) {
+									table[std::move(entry.first)].push_back(entry.second);
+								}
+							}
+						}
+						if (--state->building == 0 && !cancellation.cancelled()) {
+							then(std::shared_ptr<const Table>(state->table));
+						}
+					}, partition, count);
+				}
+			}
+		}, chunk, count);
+	}
+}
+
+template<typename F, typename Probe, typename Build>
+decltype(auto) join_combine(std::true_type, const F &function, const Probe &probe,
+		const Build &build) {
+	return function(build, probe);
+}
+
+template<typename F, typename Probe, typename Build>
+decltype(auto) join_combine(std::false_type, const F &function, const Probe &probe,
+		const Build &build) {
+	return function(probe, build);
+}
+
+// Probes table with chunks of input in parallel and constructs combine of every match directly
+// into the output collector, at the offset of its chunk. BuildA tells which side the table
+// was built on, since combine is always invoked as combine(a, b).
+template<typename BuildA, typename Collector, typename Executor, typename Key,
+	typename Function, typename Table, typename Input, typename Cancellation, typename Commit>
+void probe_join_table(const Executor &executor, const Key &key, const Function &function,
+		const std::shared_ptr<const Table> &table, const Input &input,
+		const Cancellation &cancellation, const Commit &commit) {
+	typedef std::decay_t<decltype(*std::begin(input->value))> probe_type;
+	typedef typename Table::value_type build_type;
+	typedef std::vector<std::pair<const probe_type *, const build_type *>> matches_type;
+	struct state_type {
+		explicit state_type(std::size_t count) : matches(count), pending(count) {}
+
+		std::vector<matches_type> matches;
+		std::atomic_size_t pending;
+	};
+	std::size_t size(input->value.size()), count(join_chunks(size));
+	auto state(std::make_shared<state_type>(count));
+	for (std::size_t chunk = 0; chunk < count; ++chunk) {
+		internal::execute_indexed(executor, [=]() {
+			if (!cancellation.cancelled()) {
+				util::cancellation_scope_type scope(cancellation);
+				const auto &collection(input->value);
+				auto &matches(state->matches[chunk]);
+				auto last(std::begin(collection) + (chunk + 1) * size / count);
+				for (auto it = std::begin(collection) + chunk * size / count; it != last; ++it) {
+					if (auto found = table->find(key(*it))) {
+						for (auto build : *found) {
+							matches.emplace_back(&*it, build);
+						}
+					}
+				}
+			}
+			if (--state->pending != 0 || cancellation.cancelled()) {
+				return;
+			}
+			std::vector<std::size_t> offsets;
+			std::size_t total(0);
+			for (const auto &matches : state->matches) {
+				offsets.push_back(total);
+				total += matches.size();
+			}
+			auto collector(std::make_shared<Collector>(total));
+			if (total == 0) {
+				commit(collector);
+				return;
+			}
+			for (std::size_t chunk = 0; chunk < count; ++chunk) {
+				internal::execute_indexed(executor, [=]() {
+					std::size_t index(offsets[chunk]);
+					bool complete(false);
+					util::cancellation_scope_type scope(cancellation);
+					for (const auto &match : state->matches[chunk]) {
+						complete = cancellation.cancelled() ? collector->skip(index++)
+							: collector->construct(index++, join_combine(BuildA(), function,
+								*match.first, *match.second));
+					}
+					if (complete && collector->full()) {
+						commit(collector);
+					}
+				}, chunk, count);
+			}
+		}, chunk, count);
+	}
+}
+
+} // namespace details
+
+// Inner hash join of the collections of dependency_a and dependency_b. Commits
+// function(a, b) for every pair of elements where key_a(a) equals key_b(b), in the order of the
+// larger collection. The table is built on the smaller collection and is reused by later
+// evaluations until that collection is committed again.
+template<typename Comparator, typename Hash, typename KeyA, typename KeyB, typename Function,
+	typename DependencyA, typename DependencyB>
+auto join(KeyA key_a, KeyB key_b, Function &&function, DependencyA dependency_a,
+		DependencyB dependency_b) {
+	typedef std::decay_t<typename util::unwrap_container_t<DependencyA>::value_type::value_type>
+		a_type;
+	typedef std::decay_t<typename util::unwrap_container_t<DependencyB>::value_type::value_type>
+		b_type;
+	typedef std::decay_t<decltype(key_a(std::declval<const a_type &>()))> key_type;
+	typedef std::decay_t<decltype(internal::get_function(util::unwrap_reference(
+		std::declval<Function>()))(std::declval<const a_type &>(),
+			std::declval<const b_type &>()))> value_type;
+	static_assert(!std::is_void<value_type>::value, "T must not be void type.");
+	static_assert(std::is_move_constructible<value_type>::value, "T must be move constructible");
+	typedef decltype(internal::get_storage(util::unwrap_container(dependency_a))) input_a_type;
+	typedef decltype(internal::get_storage(util::unwrap_container(dependency_b))) input_b_type;
+	typedef details::join_table_type<key_type, a_type, input_a_type, Hash> table_a_type;
+	typedef details::join_table_type<key_type, b_type, input_b_type, Hash> table_b_type;
+	typedef vector_view_type<value_type, Comparator> collector_view_type;
+	typedef details::join_commit_storage_type<collector_view_type, table_a_type, table_b_type>
+		commit_storage_type;
+
+	return details::make_repository<collector_view_type, commit_storage_type,
+			util::collection_comparator_t<Comparator, collector_view_type>>([key_a, key_b,
+				function = internal::get_function(util::unwrap_reference(std::forward<Function>(function))),
+				executor = internal::get_executor(util::unwrap_reference(std::forward<Function>(function)))](
+				auto &&callback, const auto &previous_storage, const auto &dependencies,
+				const auto &cancellation) {
+		typedef util::fixed_size_collector_type<value_type, Comparator> collector_type;
+
+		auto input_a(internal::get_storage(util::unwrap_container(std::get<0>(*dependencies))));
+		auto input_b(internal::get_storage(util::unwrap_container(std::get<1>(*dependencies))));
+		typename commit_storage_type::revisions_type revisions{ input_a->revision,
+			input_b->revision };
+		auto previous(std::atomic_load(&*previous_storage));
+
+		auto run([&](auto build_a, const auto &build_key, const auto &build_input,
+				const auto &probe_key, const auto &probe_input) {
+			typedef std::conditional_t<decltype(build_a)::value, table_a_type, table_b_type>
+				table_type;
+			constexpr std::size_t build_index(decltype(build_a)::value ? 0 : 1);
+			auto probe([=](const std::shared_ptr<const table_type> &table) {
+				details::probe_join_table<decltype(build_a), collector_type>(
+					executor, probe_key, function, table, probe_input, cancellation,
+					[=](const auto &collector) {
+						callback(std::make_shared<commit_storage_type>(
+							collector_view_type(std::move(*collector)), util::default_revision,
+							revisions, build_a, table));
+					});
+			});
+			if (previous && previous->table(build_a)
+					&& previous->revisions[build_index] == revisions[build_index]) {
+				probe(previous->table(build_a));
+			} else {
+				details::build_join_table<table_type>(executor, build_key, build_input,
+					cancellation, probe);
+			}
+		});
+		if (input_a->value.size() <= input_b->value.size()) {
+			run(std::true_type(), key_a, input_a, key_b, input_b);
+		} else {
+			run(std::false_type(), key_b, input_b, key_a, input_a);
+		}
+	}, std::forward<DependencyA>(dependency_a), std::forward<DependencyB>(dependency_b));
+}
+
+template<typename Hash, typename KeyA, typename KeyB, typename Function, typename DependencyA,
+	typename DependencyB>
+auto join(KeyA key_a, KeyB key_b, Function &&function, DependencyA dependency_a,
+		DependencyB dependency_b) {
+	typedef std::decay_t<typename util::unwrap_container_t<DependencyA>::value_type::value_type>
+		a_type;
+	typedef std::decay_t<typename util::unwrap_container_t<DependencyB>::value_type::value_type>
+		b_type;
+	typedef std::decay_t<decltype(internal::get_function(util::unwrap_reference(
+		std::declval<Function>()))(std::declval<const a_type &>(),
+			std::declval<const b_type &>()))> value_type;
+	static_assert(util::is_equality_comparable<value_type>::value,
+		"T must implement equality comparator");
+	return push::join<std::equal_to<value_type>, Hash>(std::move(key_a), std::move(key_b),
+		std::forward<Function>(function), std::forward<DependencyA>(dependency_a),
+		std::forward<DependencyB>(dependency_b));
+}
+
+template<typename KeyA, typename KeyB, typename Function, typename DependencyA,
+	typename DependencyB>
+auto join(KeyA key_a, KeyB key_b, Function &&function, DependencyA dependency_a,
+		DependencyB dependency_b) {
+	typedef std::decay_t<typename util::unwrap_container_t<DependencyA>::value_type::value_type>
+		a_type;
+	typedef std::decay_t<decltype(key_a(std::declval<const a_type &>()))> key_type;
+	return push::join<std::hash<key_type>>(std::move(key_a), std::move(key_b),
+		std::forward<Function>(function), std::forward<DependencyA>(dependency_a),
+		std::forward<DependencyB>(dependency_b));
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_JOIN_H_
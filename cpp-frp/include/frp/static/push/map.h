@@ -13,6 +13,8 @@
 #ifndef _FRP_STATIC_PUSH_MAP_H_
 #define _FRP_STATIC_PUSH_MAP_H_
 
+#include <frp/cancellation.h>
+#include <frp/comparator.h>
 #include <frp/internal/namespace_alias.h>
 #include <frp/static/push/repository.h>
 #include <frp/util/collector.h>
@@ -41,10 +43,11 @@ auto map(Function &&function, Dependencies... dependencies) {
 	typedef std::array<util::revision_type, sizeof...(Dependencies)> revisions_type;
 
 	return details::make_repository<collector_view_type, commit_storage_type,
-			std::equal_to<collector_view_type>>([
+			util::collection_comparator_t<Comparator, collector_view_type>>([
 				function = internal::get_function(util::unwrap_reference(std::forward<Function>(function))),
 				executor = internal::get_executor(util::unwrap_reference(std::forward<Function>(function)))](
-				auto &&callback, const auto &previous, const auto &dependencies) {
+				auto &&callback, const auto &previous, const auto &dependencies,
+				const auto &cancellation) {
 		typedef util::fixed_size_collector_type<value_type, Comparator> collector_type;
 		typedef vector_view_type<value_type, Comparator> collector_view_type;
 
@@ -64,19 +67,26 @@ auto map(Function &&function, Dependencies... dependencies) {
 			std::size_t counter(0);
 			for (const auto &value : collection) {
 				std::size_t index(counter++);
-				executor([function, collector, index, &value, callback, values, revisions]() {
-					auto complete(collector->construct(index,
-						util::indexed_invoke_with_replacement<I>(std::move(function),
-							std::cref(value),
-							util::invoke([&](const auto&... values) {
-								return std::tie(values->value...);
-							}, values))));
-					if (complete) {
+				internal::execute_indexed(executor, [function, collector, index, &value,
+						callback, values, revisions, cancellation]() {
+					bool complete;
+					if (cancellation.cancelled()) {
+						complete = collector->skip(index);
+					} else {
+						util::cancellation_scope_type scope(cancellation);
+						complete = collector->construct(index,
+							util::indexed_invoke_with_replacement<I>(std::move(function),
+								std::cref(value),
+								util::invoke([&](const auto&... values) {
+									return std::tie(values->value...);
+								}, values)));
+					}
+					if (complete && collector->full()) {
 						callback(std::make_shared<commit_storage_type>(
 							collector_view_type(std::move(*collector)),
 							util::default_revision, revisions));
 					}
-				});
+				}, index, collection.size());
 			}
 		}
 	}, std::forward<Dependencies>(dependencies)...);
@@ -87,19 +97,19 @@ auto map(Function &&function, Dependencies... dependencies) {
 	typedef util::map_return_t<I, Function, Dependencies...> value_type;
 	static_assert(util::is_equality_comparable<value_type>::value,
 		"T must implement equality comparator");
-	return map<I, std::equal_to<value_type>>(std::forward<Function>(function),
+	return push::map<I, std::equal_to<value_type>>(std::forward<Function>(function),
 		std::forward<Dependencies>(dependencies)...);
 }
 
 template<typename Comparator, typename Function, typename... Dependencies>
 auto map(Function &&function, Dependencies... dependencies) {
-	return map<0, Comparator>(std::forward<Function>(function),
+	return push::map<0, Comparator>(std::forward<Function>(function),
 		std::forward<Dependencies>(dependencies)...);
 }
 
 template<typename Function, typename... Dependencies>
 auto map(Function &&function, Dependencies... dependencies) {
-	return map<0>(std::forward<Function>(function), std::forward<Dependencies>(dependencies)...);
+	return push::map<0>(std::forward<Function>(function), std::forward<Dependencies>(dependencies)...);
 }
 
 } // namespace push
@@ -13,6 +13,8 @@
 #ifndef _FRP_STATIC_PUSH_MAP_CACHE_H_
 #define _FRP_STATIC_PUSH_MAP_CACHE_H_
 
+#include <frp/cancellation.h>
+#include <frp/comparator.h>
 #include <frp/internal/namespace_alias.h>
 #include <frp/static/push/repository.h>
 #include <frp/util/collector.h>
@@ -61,10 +63,11 @@ auto map_cache(Function &&function, Dependencies... dependencies) {
 		Hash, sizeof...(Dependencies)> commit_storage_type;
 	typedef std::array<util::revision_type, sizeof...(Dependencies)> revisions_type;
 	return details::make_repository<collector_view_type, commit_storage_type,
-			std::equal_to<collector_view_type>>([
+			util::collection_comparator_t<Comparator, collector_view_type>>([
 				function = internal::get_function(util::unwrap_reference(std::forward<Function>(function))),
 				executor = internal::get_executor(util::unwrap_reference(std::forward<Function>(function)))](
-				auto &&callback, const auto &previous_storage, const auto &dependencies) {
+				auto &&callback, const auto &previous_storage, const auto &dependencies,
+				const auto &cancellation) {
 		typedef util::fixed_size_collector_type<value_type, Comparator> collector_type;
 		typedef vector_view_type<value_type, Comparator> collector_view_type;
 
@@ -88,17 +91,19 @@ auto map_cache(Function &&function, Dependencies... dependencies) {
 				revisions, previous->revisions));
 			for (const auto &value : collection) {
 				std::size_t index(counter++);
-				executor([function, collector, index, &value, callback, previous, revisions,
-					cache_usable, values]() {
+				internal::execute_indexed(executor, [function, collector, index, &value,
+					callback, previous, revisions, cache_usable, values, cancellation]() {
 					auto &collection(std::get<I>(values)->value);
 					typename commit_storage_type::cache_type::iterator it;
-					if (cache_usable && (it = previous->cache.find(value))
+					util::cancellation_scope_type scope(cancellation);
+					if ((cancellation.cancelled() ? collector->skip(index)
+						: cache_usable && (it = previous->cache.find(value))
 						!= previous->cache.end() ? collector->construct(index, it->second)
 						: collector->construct(index,
 							util::indexed_invoke_with_replacement<I>(std::move(function),
 								std::cref(value), util::invoke([&](const auto&... storage) {
 									return std::tie(storage->value...);
-								}, values)))) {
+								}, values)))) && collector->full()) {
 						auto commit(std::make_shared<commit_storage_type>(
 							collector_view_type(std::move(*collector)),
 							util::default_revision, revisions));
@@ -110,7 +115,7 @@ auto map_cache(Function &&function, Dependencies... dependencies) {
 							});
 						callback(commit);
 					}
-				});
+				}, index, collection.size());
 			}
 		}
 	}, std::forward<Dependencies>(dependencies)...);
@@ -121,7 +126,7 @@ auto map_cache(Function &&function, Dependencies... dependencies) {
 	typedef util::map_return_t<I, Function, Dependencies...> value_type;
 	static_assert(util::is_equality_comparable<value_type>::value,
 		"T must implement equality comparator");
-	return map_cache<I, std::equal_to<value_type>, Hash>(std::forward<Function>(function),
+	return push::map_cache<I, std::equal_to<value_type>, Hash>(std::forward<Function>(function),
 		std::forward<Dependencies>(dependencies)...);
 }
 
@@ -130,13 +135,13 @@ auto map_cache(Function &&function, Dependencies... dependencies) {
 	typedef typename util::unwrap_reference_t<std::tuple_element_t<I, std::tuple<Dependencies...>>>
 		::value_type argument_container_type;
 	typedef typename argument_container_type::value_type argument_type;
-	return map_cache<I, std::hash<argument_type>>(std::forward<Function>(function),
+	return push::map_cache<I, std::hash<argument_type>>(std::forward<Function>(function),
 		std::forward<Dependencies>(dependencies)...);
 }
 
 template<typename Comparator, typename Hash, typename Function, typename Dependency>
 auto map_cache(Function &&function, Dependency dependency) {
-	return map_cache<0, Comparator, Hash>(std::forward<Function>(function),
+	return push::map_cache<0, Comparator, Hash>(std::forward<Function>(function),
 		std::forward<Dependency>(dependency));
 }
 
@@ -145,13 +150,13 @@ auto map_cache(Function &&function, Dependency dependency) {
 	typedef util::map_return_t<0, Function, Dependency> value_type;
 	static_assert(util::is_equality_comparable<value_type>::value,
 		"T must implement equality comparator");
-	return map_cache<std::equal_to<value_type>, Hash>(std::forward<Function>(function),
+	return push::map_cache<std::equal_to<value_type>, Hash>(std::forward<Function>(function),
 		std::forward<Dependency>(dependency));
 }
 
 template<typename Function, typename Dependency>
 auto map_cache(Function &&function, Dependency dependency) {
-	return map_cache<0>(std::forward<Function>(function), std::forward<Dependency>(dependency));
+	return push::map_cache<0>(std::forward<Function>(function), std::forward<Dependency>(dependency));
 }
 
 } // namespace push
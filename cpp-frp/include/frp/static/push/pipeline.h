@@ -0,0 +1,261 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_PIPELINE_H_
+#define _FRP_STATIC_PUSH_PIPELINE_H_
+
+#include <frp/cancellation.h>
+#include <frp/comparator.h>
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/repository.h>
+#include <frp/util/collector.h>
+#include <frp/vector_view.h>
+#include <tuple>
+#include <type_traits>
+
+namespace frp {
+namespace stat {
+namespace push {
+
+template<typename Function>
+struct mapped_type {
+	template<typename T, typename Next>
+	bool operator()(T &&value, Next &&next) const {
+		return next(function(std::forward<T>(value)));
+	}
+
+	Function function;
+};
+
+template<typename Function>
+struct filtered_type {
+	template<typename T, typename Next>
+	bool operator()(T &&value, Next &&next) const {
+		return function(static_cast<const std::decay_t<T> &>(value))
+			&& next(std::forward<T>(value));
+	}
+
+	Function function;
+};
+
+// Element-wise stages applied to every element of a collection dependency, see fuse.
+template<typename Dependency, typename... Stages>
+struct pipeline_type {
+	Dependency dependency;
+	std::tuple<Stages...> stages;
+};
+
+template<typename Function>
+mapped_type<std::decay_t<Function>> mapped(Function &&function) {
+	return { std::forward<Function>(function) };
+}
+
+template<typename Function>
+filtered_type<std::decay_t<Function>> filtered(Function &&function) {
+	return { std::forward<Function>(function) };
+}
+
+namespace details {
+
+template<typename T>
+struct is_stage : std::false_type {};
+
+template<typename Function>
+struct is_stage<mapped_type<Function>> : std::true_type {};
+
+template<typename Function>
+struct is_stage<filtered_type<Function>> : std::true_type {};
+
+template<typename T>
+struct is_pipeline : std::false_type {};
+
+template<typename Dependency, typename... Stages>
+struct is_pipeline<pipeline_type<Dependency, Stages...>> : std::true_type {};
+
+template<typename T, typename... Stages>
+struct stages_result_type {
+	typedef T type;
+	static constexpr bool ordered = true;
+};
+
+template<typename T, typename Function, typename... Stages>
+struct stages_result_type<T, mapped_type<Function>, Stages...>
+	: stages_result_type<std::decay_t<std::result_of_t<const Function &(const T &)>>,
+		Stages...> {};
+
+// Filtering stages leave holes, the remaining elements are then collected in completion order
+// just like filter does.
+template<typename T, typename Function, typename... Stages>
+struct stages_result_type<T, filtered_type<Function>, Stages...>
+	: stages_result_type<T, Stages...> {
+	static constexpr bool ordered = false;
+};
+
+template<typename T, typename Stages>
+struct tuple_stages_result_type;
+
+template<typename T, typename... Stages>
+struct tuple_stages_result_type<T, std::tuple<Stages...>> : stages_result_type<T, Stages...> {};
+
+template<typename Pipeline>
+using pipeline_result_type = tuple_stages_result_type<typename util::unwrap_container_t<
+	decltype(Pipeline::dependency)>::value_type::value_type, decltype(Pipeline::stages)>;
+
+template<std::size_t I, typename Stages, typename Sink, typename T>
+std::enable_if_t<I == std::tuple_size<Stages>::value, bool> apply_stages(const Stages &,
+		Sink &sink, T &&value) {
+	return sink(std::forward<T>(value));
+}
+
+// Every stage hands its result straight to the next one, no intermediate collection is made.
+template<std::size_t I, typename Stages, typename Sink, typename T>
+std::enable_if_t<I < std::tuple_size<Stages>::value, bool> apply_stages(const Stages &stages,
+		Sink &sink, T &&value) {
+	return std::get<I>(stages)(std::forward<T>(value), [&](auto &&value) {
+		return apply_stages<I + 1>(stages, sink, std::forward<decltype(value)>(value));
+	});
+}
+
+template<typename T, typename Comparator>
+struct ordered_output_type {
+	typedef util::fixed_size_collector_type<T, Comparator> collector_type;
+
+	template<typename U>
+	static bool construct(collector_type &collector, std::size_t index, U &&value) {
+		return collector.construct(index, std::forward<U>(value));
+	}
+
+	static bool skip(collector_type &collector, std::size_t index) {
+		return collector.skip(index);
+	}
+
+	static bool committable(const collector_type &collector, const util::cancellation_type &) {
+		return collector.full();
+	}
+};
+
+template<typename T, typename Comparator>
+struct unordered_output_type {
+	typedef util::append_collector_type<T, Comparator> collector_type;
+
+	template<typename U>
+	static bool construct(collector_type &collector, std::size_t, U &&value) {
+		return collector.construct(std::forward<U>(value));
+	}
+
+	static bool skip(collector_type &collector, std::size_t) {
+		return collector.skip();
+	}
+
+	// Skipped elements are indistinguishable from rejected ones.
+	static bool committable(const collector_type &,
+			const util::cancellation_type &cancellation) {
+		return !cancellation.cancelled();
+	}
+};
+
+} // namespace details
+
+template<typename Dependency, typename Stage, typename = std::enable_if_t<
+	details::is_stage<Stage>::value && !details::is_pipeline<std::decay_t<Dependency>>::value>>
+pipeline_type<std::decay_t<Dependency>, Stage> operator|(Dependency &&dependency, Stage stage) {
+	return { std::forward<Dependency>(dependency), std::make_tuple(std::move(stage)) };
+}
+
+template<typename Dependency, typename... Stages, typename Stage,
+	typename = std::enable_if_t<details::is_stage<Stage>::value>>
+pipeline_type<Dependency, Stages..., Stage> operator|(
+		pipeline_type<Dependency, Stages...> &&pipeline, Stage stage) {
+	return { std::move(pipeline.dependency),
+		std::tuple_cat(std::move(pipeline.stages), std::make_tuple(std::move(stage))) };
+}
+
+// Runs all stages of a pipeline as one task per element, writing only the final results into a
+// single collection. Wrap the pipeline with execute_on to choose the executor.
+template<typename Comparator, typename Pipeline>
+auto fuse(Pipeline &&pipeline) {
+	typedef internal::get_function_t<std::decay_t<Pipeline>> pipeline_type;
+	static_assert(details::is_pipeline<pipeline_type>::value,
+		"fuse expects dependency | mapped(f) | filtered(g) | ...");
+	typedef details::pipeline_result_type<pipeline_type> result_type;
+	typedef typename result_type::type value_type;
+	static_assert(!std::is_void<value_type>::value, "T must not be void type.");
+	static_assert(std::is_move_constructible<value_type>::value, "T must be move constructible");
+	typedef std::conditional_t<result_type::ordered,
+		details::ordered_output_type<value_type, Comparator>,
+		details::unordered_output_type<value_type, Comparator>> output_type;
+	typedef typename output_type::collector_type collector_type;
+	typedef vector_view_type<value_type, Comparator> collector_view_type;
+	typedef util::commit_storage_type<collector_view_type, 1> commit_storage_type;
+	typedef typename commit_storage_type::revisions_type revisions_type;
+
+	auto executor(internal::get_executor(std::forward<Pipeline>(pipeline)));
+	auto function(internal::get_function(std::forward<Pipeline>(pipeline)));
+	return details::make_repository<collector_view_type, commit_storage_type,
+			util::collection_comparator_t<Comparator, collector_view_type>>([
+				stages = std::move(function.stages), executor = std::move(executor)](
+				auto &&callback, const auto &, const auto &dependencies,
+				const auto &cancellation) {
+		auto values(util::invoke([&](const auto&... dependency) {
+			return std::make_tuple(internal::get_storage(util::unwrap_container(dependency))...);
+		}, *dependencies));
+		revisions_type revisions{ std::get<0>(values)->revision };
+		auto &collection(std::get<0>(values)->value);
+		if (collection.empty()) {
+			callback(std::make_shared<commit_storage_type>(
+				collector_view_type(collector_type(0)), util::default_revision, revisions));
+		} else {
+			auto collector(std::make_shared<collector_type>(collection.size()));
+			std::size_t counter(0);
+			for (const auto &value : collection) {
+				std::size_t index(counter++);
+				internal::execute_indexed(executor, [stages, collector, index, &value, callback,
+						values, revisions, cancellation]() {
+					bool complete(false);
+					if (cancellation.cancelled()) {
+						complete = output_type::skip(*collector, index);
+					} else {
+						util::cancellation_scope_type scope(cancellation);
+						auto sink([&](auto &&result) {
+							complete = output_type::construct(*collector, index,
+								std::forward<decltype(result)>(result));
+							return true;
+						});
+						if (!details::apply_stages<0>(stages, sink, value)) {
+							complete = output_type::skip(*collector, index);
+						}
+					}
+					if (complete && output_type::committable(*collector, cancellation)) {
+						callback(std::make_shared<commit_storage_type>(
+							collector_view_type(std::move(*collector)),
+							util::default_revision, revisions));
+					}
+				}, index, collection.size());
+			}
+		}
+	}, std::move(function.dependency));
+}
+
+template<typename Pipeline>
+auto fuse(Pipeline &&pipeline) {
+	typedef typename details::pipeline_result_type<
+		internal::get_function_t<std::decay_t<Pipeline>>>::type value_type;
+	static_assert(util::is_equality_comparable<value_type>::value,
+		"T must implement equality comparator");
+	return push::fuse<std::equal_to<value_type>>(std::forward<Pipeline>(pipeline));
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_PIPELINE_H_
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_PROJECT_H_
+#define _FRP_STATIC_PUSH_PROJECT_H_
+
+#include <frp/comparator.h>
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/repository.h>
+#include <functional>
+#include <memory>
+
+namespace frp {
+namespace stat {
+namespace push {
+namespace details {
+
+// Refers to a member of the value committed by the dependency, which it keeps alive.
+template<typename T, typename Parent>
+struct projection_storage_type : util::commit_storage_type<std::reference_wrapper<const T>, 1> {
+	typedef util::commit_storage_type<std::reference_wrapper<const T>, 1> parent_type;
+
+	projection_storage_type(const std::shared_ptr<Parent> &parent, const T &value,
+		const typename parent_type::revisions_type &revisions)
+		: parent_type(std::cref(value), util::default_revision, revisions), parent(parent) {}
+
+	std::shared_ptr<const Parent> parent;
+};
+
+template<typename Comparator>
+struct projection_comparator_type {
+	template<typename T>
+	bool operator()(const std::reference_wrapper<const T> &lhs,
+			const std::reference_wrapper<const T> &rhs) const {
+		return comparator(lhs.get(), rhs.get());
+	}
+
+	Comparator comparator;
+};
+
+template<typename Comparator>
+using projection_comparator_t = std::conditional_t<util::is_never_equal<Comparator>::value,
+	never_equal, projection_comparator_type<Comparator>>;
+
+} // namespace details
+
+// Commits a reference to member of the value of dependency, without copying it. Dependents are
+// only woken if the member changed according to Comparator, whatever else changed.
+template<typename Comparator, typename T, typename U, typename Dependency>
+auto project(T U::*member, Dependency dependency) {
+	typedef typename util::unwrap_container_t<Dependency>::value_type parent_value_type;
+	static_assert(std::is_base_of<U, parent_value_type>::value,
+		"member must belong to the value type of dependency.");
+	typedef details::projection_storage_type<T, util::storage_type<parent_value_type>>
+		storage_type;
+	typedef typename storage_type::revisions_type revisions_type;
+	return details::make_repository<std::reference_wrapper<const T>, storage_type,
+		details::projection_comparator_t<Comparator>>([member](auto &&callback, const auto &,
+			const auto &dependencies, const auto &) {
+		auto parent(internal::get_storage(util::unwrap_container(std::get<0>(*dependencies))));
+		const parent_value_type &value(parent->value);
+		callback(std::make_shared<storage_type>(parent, value.*member,
+			revisions_type{ parent->revision }));
+	}, std::forward<Dependency>(dependency));
+}
+
+template<typename T, typename U, typename Dependency>
+auto project(T U::*member, Dependency dependency) {
+	static_assert(util::is_equality_comparable<T>::value,
+		"T must implement equality comparator");
+	return push::project<std::equal_to<T>>(member, std::forward<Dependency>(dependency));
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_PROJECT_H_
@@ -13,7 +13,10 @@
 #ifndef _FRP_STATIC_PUSH_REPOSITORY_H_
 #define _FRP_STATIC_PUSH_REPOSITORY_H_
 
+#include <frp/cancellation.h>
+#include <frp/comparator.h>
 #include <frp/execute_on.h>
+#include <frp/instrumentation.h>
 #include <frp/internal/namespace_alias.h>
 #include <frp/internal/operator.h>
 #include <frp/util/function.h>
@@ -23,6 +26,7 @@
 #include <frp/util/storage.h>
 #include <frp/util/variadic.h>
 #include <frp/util/vector.h>
+#include <mutex>
 
 namespace frp {
 namespace stat {
@@ -36,37 +40,135 @@ namespace details {
 template<typename Storage, typename Comparator>
 void submit_commit(const std::shared_ptr<std::shared_ptr<Storage>> &storage,
 		const std::shared_ptr<util::observable_type> &observable,
-		const Comparator &comparator, const std::shared_ptr<Storage> &current) {
+		const Comparator &comparator, const util::instrumentation_type &instrumentation,
+		typename util::instrumentation_type::start_type start,
+		const std::shared_ptr<Storage> &current) {
 	auto value(std::atomic_load(&*storage));
 	bool exchanged(false), equals;
 	do {
 		current->revision = (value ? value->revision : util::default_revision) + 1;
-		equals = value && current->compare_value(*value, comparator);
+		equals = !util::is_never_equal<Comparator>::value && value
+			&& current->compare_value(*value, comparator);
 	} while ((!value || value->is_newer(current->revisions))
 		&& !(exchanged = std::atomic_compare_exchange_strong(&*storage, &value, current)));
-	if (exchanged && !equals) {
+	if (!exchanged) {
+		instrumentation.rejected(start);
+	} else if (equals) {
+		instrumentation.suppressed(start, *current);
+	} else {
+		instrumentation.committed(start, *current);
 		observable->update();
 	}
 }
 
+// Every attempt cancels the evaluations started by earlier ones.
 template<typename Storage, typename Generator, typename Comparator, typename... Dependencies>
 void attempt_commit_callback(const std::shared_ptr<std::shared_ptr<Storage>> &storage,
 		const std::shared_ptr<Generator> &generator, Comparator &comparator,
 		const std::shared_ptr<util::observable_type> &observable,
-		const std::shared_ptr<std::tuple<Dependencies...>> &dependencies) {
+		const std::shared_ptr<std::tuple<Dependencies...>> &dependencies,
+		const std::shared_ptr<util::generation_type> &generation,
+		const util::instrumentation_type &instrumentation) {
 	bool available(util::invoke([&](const Dependencies&... dependencies) {
 		return util::all_true(internal::get_storage(util::unwrap_container(dependencies))...);
 	}, *dependencies));
 	if (available) {
+		auto start(instrumentation.evaluation_started());
 		(*generator)(std::bind(&submit_commit<Storage, Comparator>, storage, observable,
-			comparator, std::placeholders::_1), storage, dependencies);
+			comparator, instrumentation, start, std::placeholders::_1), storage, dependencies,
+			util::next_cancellation(generation, start));
+	}
+}
+
+// Recomputes only if the dependencies were committed since the current value was.
+template<typename Storage, typename Callback, typename... Dependencies>
+void catch_up(const std::shared_ptr<std::shared_ptr<Storage>> &storage, Callback &callback,
+		const std::shared_ptr<std::tuple<Dependencies...>> &dependencies) {
+	auto value(std::atomic_load(&*storage));
+	bool stale(util::invoke([&](const Dependencies&... dependencies) {
+		auto storages(std::make_tuple(
+			internal::get_storage(util::unwrap_container(dependencies))...));
+		return !value || util::invoke([&](const auto&... storages) {
+			return !util::all_true(storages...) || value->revisions
+				!= typename Storage::revisions_type{ storages->revision... };
+		}, storages);
+	}, *dependencies));
+	if (stale) {
+		callback();
 	}
 }
 
+// A repository which has been observed releases its dependency callbacks once its last
+// observer is gone, which in turn releases demand upstream. Observing it again subscribes
+// and catches up on whatever was committed in the meantime.
+struct demand_type {
+	typedef std::vector<util::observable_type::reference_type> callbacks_type;
+
+	template<typename Subscribe, typename CatchUp>
+	demand_type(Subscribe &&subscribe, CatchUp &&catch_up)
+		: subscribe(std::forward<Subscribe>(subscribe))
+		, catch_up(std::forward<CatchUp>(catch_up))
+		, callbacks(this->subscribe())
+		, observed(false)
+		, suspended(false) {}
+
+	void update(const util::observable_type &observable) {
+		callbacks_type released;
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!observable.observed()) {
+			if (observed && !suspended) {
+				suspended = true;
+				released.swap(callbacks);
+			}
+		} else if (suspended) {
+			suspended = false;
+			callbacks = subscribe();
+			catch_up();
+		} else {
+			observed = true;
+		}
+	}
+
+	std::function<callbacks_type()> subscribe;
+	std::function<void()> catch_up;
+	callbacks_type callbacks;
+	bool observed;
+	bool suspended;
+	std::mutex mutex;
+};
+
 template<typename T, typename Storage, typename Comparator, typename Generator,
 	typename... Dependencies>
 repository_type<T> make_repository(Generator &&generator, Dependencies &&... dependencies);
 
+// Commits values committed by another repository as they are, without copying or assigning a
+// revision of its own. Used by operators that decide when to commit rather than what.
+template<typename T>
+struct forwarder_type {
+	typedef std::shared_ptr<util::storage_type<T>> value_type;
+
+	// Every value is forwarded at most once, and never an older one. Returns whether value
+	// was stored.
+	bool forward(const value_type &value) {
+		auto current(std::atomic_load(&storage));
+		do {
+			if (!value || (current && current->revision >= value->revision)) {
+				return false;
+			}
+		} while (!std::atomic_compare_exchange_weak(&storage, &current, value));
+		observable.update();
+		return true;
+	}
+
+	value_type storage; // Use atomics!
+	util::observable_type observable;
+};
+
+template<typename T, typename State>
+repository_type<T> make_forwarding_repository(const std::shared_ptr<State> &state,
+	const std::shared_ptr<forwarder_type<T>> &forwarder,
+	const util::instrumentation_type &instrumentation);
+
 } // namespace details
 
 template<typename T>
@@ -76,29 +178,45 @@ struct repository_type {
 		typename... Dependencies>
 	friend repository_type<U> details::make_repository(Generator &&generator,
 		Dependencies &&... dependencies);
+	template<typename U, typename State>
+	friend repository_type<U> details::make_forwarding_repository(
+		const std::shared_ptr<State> &state,
+		const std::shared_ptr<details::forwarder_type<U>> &forwarder,
+		const util::instrumentation_type &instrumentation);
 	template<typename O, typename F>
 	friend auto util::add_callback(O &observable, F &&f)
 		->decltype(observable.add_callback(std::forward<F>(f)));
 	template<typename U>
 	friend auto internal::get_storage(U &value)->decltype(value.get_storage());
+	template<typename U>
+	friend auto internal::get_instrumentation(U &value)->decltype(value.get_instrumentation());
 
 	typedef T value_type;
 
 	repository_type() = default;
+	repository_type(const repository_type &) = delete;
+	repository_type(repository_type &&) = default;
+	repository_type &operator=(const repository_type &) = delete;
+	repository_type &operator=(repository_type &&) = default;
 
 private:
-	template<typename Update, typename Provider, typename... Dependencies>
-	repository_type(const std::shared_ptr<util::observable_type> &observable, const Update &update,
-		Provider &&provider, const std::shared_ptr<std::tuple<Dependencies...>> &dependencies)
-		: observable(observable)
-		, callbacks(util::vector_from_array(util::invoke(
-			util::observe_all(update), std::ref(*dependencies))))
-		, provider(std::forward<Provider>(provider)) {}
+	template<typename Provider>
+	repository_type(const std::shared_ptr<util::observable_type> &observable,
+		const std::shared_ptr<details::demand_type> &demand, Provider &&provider,
+		const util::instrumentation_type &instrumentation)
+		: provider(std::forward<Provider>(provider))
+		, observable(observable)
+		, demand(demand)
+		, instrumentation(instrumentation) {}
 
 	auto get_storage() const {
 		return provider();
 	}
 
+	const auto &get_instrumentation() const {
+		return instrumentation;
+	}
+
 	template<typename F>
 	auto add_callback(F &&f) const {
 		return observable->add_callback(std::forward<F>(f));
@@ -106,7 +224,8 @@ private:
 
 	std::function<std::shared_ptr<util::storage_type<T>>()> provider;
 	std::shared_ptr<util::observable_type> observable;
-	std::vector<util::observable_type::reference_type> callbacks;
+	std::shared_ptr<details::demand_type> demand;
+	util::instrumentation_type instrumentation;
 };
 
 namespace details {
@@ -120,20 +239,51 @@ repository_type<T> make_repository(Generator &&generator, Dependencies &&... dep
 	auto observable(std::make_shared<util::observable_type>());
 	auto shared_dependencies(std::make_shared<std::tuple<Dependencies...>>(
 		std::forward<Dependencies>(dependencies)...));
+	auto instrumentation(util::invoke([](const Dependencies&... dependencies) {
+		return util::instrumentation_type::make<T>(
+			internal::get_instrumentation(util::unwrap_container(dependencies))...);
+	}, *shared_dependencies));
 	auto callback(std::bind(
 		&attempt_commit_callback<Storage, Generator, Comparator, Dependencies...>,
 		storage, std::make_shared<Generator>(std::forward<Generator>(generator)), Comparator(),
-		observable, shared_dependencies));
+		observable, shared_dependencies, std::make_shared<util::generation_type>(0),
+		instrumentation));
 	auto provider([=]() { return std::atomic_load(&*storage); });
-	repository_type<T> repository(observable, callback, provider, shared_dependencies);
+	auto demand(std::make_shared<demand_type>([=]() {
+		return util::vector_from_array(util::invoke(util::observe_all(callback),
+			std::ref(*shared_dependencies)));
+	}, [=]() mutable { catch_up(storage, callback, shared_dependencies); }));
+	// Runs on the trampoline so that suspending or resuming a long chain does not recurse.
+	observable->set_demand_callback([weak_demand = std::weak_ptr<demand_type>(demand),
+		weak_observable = std::weak_ptr<util::observable_type>(observable)](const auto &) {
+			internal::execute_immediate_type()([=]() {
+				auto demand(weak_demand.lock());
+				auto observable(weak_observable.lock());
+				if (demand && observable) {
+					demand->update(*observable);
+				}
+			});
+		});
+	repository_type<T> repository(observable, demand, provider, instrumentation);
 	callback();
 	return repository;
 }
 
+// The repository keeps state alive, callbacks and timers must only refer to it weakly.
+template<typename T, typename State>
+repository_type<T> make_forwarding_repository(const std::shared_ptr<State> &state,
+		const std::shared_ptr<forwarder_type<T>> &forwarder,
+		const util::instrumentation_type &instrumentation) {
+	return repository_type<T>(std::shared_ptr<util::observable_type>(forwarder,
+		&forwarder->observable), nullptr, [state, forwarder]() {
+			return std::atomic_load(&forwarder->storage);
+		}, instrumentation);
+}
+
 } // namespace details
 
 } // namespace push
 } // namespace stat
 } // namespace frp
 
-#endif  // _FRP_STATIC_PUSH_REPOSITORY_H_
+#endif // _FRP_STATIC_PUSH_REPOSITORY_H_
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_SAMPLE_H_
+#define _FRP_STATIC_PUSH_SAMPLE_H_
+
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/repository.h>
+#include <memory>
+
+namespace frp {
+namespace stat {
+namespace push {
+namespace details {
+
+template<typename Clock, typename Dependency>
+struct sample_state_type {
+	typedef typename util::unwrap_container_t<Dependency>::value_type value_type;
+
+	sample_state_type(Clock &&clock, Dependency &&dependency)
+		: clock(std::forward<Clock>(clock))
+		, dependency(std::forward<Dependency>(dependency))
+		, forwarder(std::make_shared<forwarder_type<value_type>>())
+		, instrumentation(util::instrumentation_type::make<value_type>(
+			internal::get_instrumentation(util::unwrap_container(this->clock)),
+			internal::get_instrumentation(util::unwrap_container(this->dependency)))) {}
+
+	// Revisions already forwarded are ignored, ticks while dependency is unchanged are free.
+	void forward() {
+		auto start(instrumentation.evaluation_started());
+		auto value(internal::get_storage(util::unwrap_container(dependency)));
+		if (forwarder->forward(value)) {
+			instrumentation.committed(start, *value);
+		}
+	}
+
+	Clock clock;
+	Dependency dependency;
+	std::shared_ptr<forwarder_type<value_type>> forwarder;
+	util::instrumentation_type instrumentation;
+	util::observable_type::reference_type callback;
+	util::observable_type::reference_type dependency_callback;
+};
+
+} // namespace details
+
+// Commits the latest value of dependency whenever clock commits. The value is shared with
+// dependency rather than copied. dependency is observed so that it is kept up to date.
+template<typename Clock, typename Dependency>
+auto sample(Clock clock, Dependency dependency) {
+	typedef details::sample_state_type<Clock, Dependency> state_type;
+	static_assert(!std::is_void<typename state_type::value_type>::value,
+		"Dependency must not be void type.");
+	auto state(std::make_shared<state_type>(std::forward<Clock>(clock),
+		std::forward<Dependency>(dependency)));
+	state->callback = util::add_callback(util::unwrap_container(state->clock),
+		[weak_state = std::weak_ptr<state_type>(state)]() {
+			if (auto state = weak_state.lock()) {
+				state->forward();
+			}
+		});
+	state->dependency_callback = util::add_callback(util::unwrap_container(state->dependency),
+		[]() {});
+	state->forward();
+	return details::make_forwarding_repository<typename state_type::value_type>(state,
+		state->forwarder, state->instrumentation);
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_SAMPLE_H_
@@ -13,12 +13,16 @@
 #ifndef _FRP_STATIC_PUSH_SINK_H_
 #define _FRP_STATIC_PUSH_SINK_H_
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <frp/internal/namespace_alias.h>
 #include <frp/internal/operator.h>
 #include <frp/util/observable.h>
 #include <frp/util/reference.h>
 #include <frp/util/storage.h>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 
 namespace frp {
@@ -63,6 +67,15 @@ struct sink_type {
 			return operator*();
 		}
 
+		util::revision_type revision() const {
+			if (!value) {
+				throw std::domain_error("value not available");
+			}
+			else {
+				return value->revision;
+			}
+		}
+
 	private:
 		explicit reference(std::shared_ptr<util::storage_type<T>> &&value)
 			: value(std::forward<std::shared_ptr<util::storage_type<T>>>(value)) {}
@@ -70,26 +83,72 @@ struct sink_type {
 	};
 
 	reference operator*() const {
-		return reference(provider());
+		return reference(storage->get());
 	}
 
-private:
-	template<typename Dependency>
-	struct template_storage_type {
+	// Blocks until a value newer than revision is available or the timeout expires.
+	// The returned reference is not newer than revision if the timeout expired.
+	template<typename Rep, typename Period>
+	reference wait_for_revision(util::revision_type revision,
+			const std::chrono::duration<Rep, Period> &timeout) const {
+		return reference(storage->wait_for_revision(revision, timeout));
+	}
 
-		explicit template_storage_type(Dependency &&dependency)
-			: dependency(std::forward<Dependency>(dependency)) {}
+private:
+	struct storage_type {
+		storage_type() : waiters(0) {}
 
 		std::shared_ptr<util::storage_type<T>> get() const {
 			return std::atomic_load(&value);
 		}
 
-		void evaluate() {
-			std::atomic_store(&value,
-				internal::get_storage(util::unwrap_container(dependency)));
+		void store(std::shared_ptr<util::storage_type<T>> &&value) {
+			std::atomic_store(&this->value, std::move(value));
+			// Pairs with the fence in wait_for_revision, either the waiter observes the new
+			// value or we observe the waiter.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (waiters.load(std::memory_order_relaxed)) {
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+				}
+				condition.notify_all();
+			}
+		}
+
+		template<typename Rep, typename Period>
+		auto wait_for_revision(util::revision_type revision,
+				const std::chrono::duration<Rep, Period> &timeout) {
+			auto current(get());
+			auto newer([&]() {
+				current = get();
+				return current && current->revision > revision;
+			});
+			if (!newer()) {
+				std::unique_lock<std::mutex> lock(mutex);
+				waiters.fetch_add(1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				condition.wait_for(lock, timeout, newer);
+				waiters.fetch_sub(1, std::memory_order_relaxed);
+			}
+			return current;
 		}
 
 		std::shared_ptr<util::storage_type<T>> value; // Use atomics!
+		std::atomic_size_t waiters;
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+
+	template<typename Dependency>
+	struct template_storage_type : storage_type {
+
+		explicit template_storage_type(Dependency &&dependency)
+			: dependency(std::forward<Dependency>(dependency)) {}
+
+		void evaluate() {
+			storage_type::store(internal::get_storage(util::unwrap_container(dependency)));
+		}
+
 		Dependency dependency;
 	};
 
@@ -101,7 +160,7 @@ private:
 
 	template<typename Storage>
 	explicit sink_type(const std::shared_ptr<Storage> &storage)
-		: provider([=]() { return storage->get(); })
+		: storage(storage)
 		, callback(util::add_callback(util::unwrap_reference(storage->dependency),
 			[weak_storage = std::weak_ptr<Storage>(storage)]() {
 				auto s(weak_storage.lock());
@@ -112,7 +171,7 @@ private:
 		storage->evaluate();
 	}
 
-	std::function<std::shared_ptr<util::storage_type<T>>()> provider;
+	std::shared_ptr<storage_type> storage;
 	util::observable_type::reference_type callback;
 };
 
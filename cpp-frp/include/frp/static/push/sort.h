@@ -0,0 +1,350 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_SORT_H_
+#define _FRP_STATIC_PUSH_SORT_H_
+
+#include <algorithm>
+#include <atomic>
+#include <frp/cancellation.h>
+#include <frp/comparator.h>
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/repository.h>
+#include <frp/util/collector.h>
+#include <frp/vector_view.h>
+#include <vector>
+
+namespace frp {
+namespace stat {
+namespace push {
+namespace details {
+
+// Inputs smaller than a grain are sorted by a single task.
+constexpr std::size_t sort_grain_size = 1 << 12;
+constexpr std::size_t sort_max_buckets = 64;
+constexpr std::size_t sort_oversampling = 8;
+
+template<typename Container, typename Input, std::size_t DependenciesN>
+struct sort_commit_storage_type : util::commit_storage_type<Container, DependenciesN> {
+	typedef util::commit_storage_type<Container, DependenciesN> parent_type;
+	typedef typename parent_type::revisions_type revisions_type;
+
+	// The collection that was sorted, only kept by incremental_sort.
+	Input input;
+
+	sort_commit_storage_type(Container &&value, util::revision_type revision,
+		const revisions_type &revisions, const Input &input)
+		: parent_type(std::forward<Container>(value), revision, revisions), input(input) {}
+};
+
+// Invokes function with a and b followed by the values of every dependency but I.
+template<std::size_t I, typename Function, typename T, typename Values, std::size_t... Is>
+bool sort_less(const Function &function, const T &a, const T &b, const Values &values,
+		std::index_sequence<Is...>) {
+	return function(a, b, std::get<(Is < I ? Is : Is + 1)>(values)->value...);
+}
+
+template<typename T>
+struct sort_buckets_type {
+	explicit sort_buckets_type(std::size_t count)
+		: buckets(count, std::vector<std::vector<const T *>>(count))
+		, offsets(count)
+		, pending(count) {}
+
+	std::vector<const T *> splitters;
+	std::vector<std::vector<std::vector<const T *>>> buckets; // [chunk][bucket]
+	std::vector<std::size_t> offsets;
+	std::atomic_size_t pending;
+};
+
+// Second pass of sample_sort, each bucket is sorted and constructed at its offset.
+template<typename Executor, typename Less, typename T, typename Collector, typename Commit,
+	typename Cancellation>
+void sort_buckets(const Executor &executor, const Less &less,
+		const std::shared_ptr<sort_buckets_type<T>> &buckets,
+		const std::shared_ptr<Collector> &collector, const Commit &commit,
+		const Cancellation &cancellation) {
+	std::size_t count(buckets->offsets.size()), offset(0);
+	for (std::size_t bucket = 0; bucket < count; ++bucket) {
+		buckets->offsets[bucket] = offset;
+		for (const auto &row : buckets->buckets) {
+			offset += row[bucket].size();
+		}
+	}
+	for (std::size_t bucket = 0; bucket < count; ++bucket) {
+		internal::execute_indexed(executor, [=]() {
+			std::vector<const T *> elements;
+			for (const auto &row : buckets->buckets) {
+				elements.insert(elements.end(), row[bucket].begin(), row[bucket].end());
+			}
+			std::size_t index(buckets->offsets[bucket]);
+			bool complete(false);
+			if (cancellation.cancelled()) {
+				for (std::size_t i = 0; i < elements.size(); ++i) {
+					collector->skip(index++);
+				}
+			} else {
+				util::cancellation_scope_type scope(cancellation);
+				std::sort(elements.begin(), elements.end(), [&](const T *a, const T *b) {
+					return less(*a, *b);
+				});
+				for (auto element : elements) {
+					complete = collector->construct(index++, *element);
+				}
+			}
+			if (complete && collector->full()) {
+				commit(collector);
+			}
+		}, bucket, count);
+	}
+}
+
+// Sample sort. Splitters picked from a sample of the input bound one bucket per chunk of the
+// input. Chunks are distributed over the buckets in parallel, then the buckets are sorted in
+// parallel directly into their range of the collector. Elements are never copied but once.
+// The collector is only allocated once every chunk has been distributed.
+template<typename Collector, typename Executor, typename Less, typename Input, typename Commit,
+	typename Cancellation>
+void sample_sort(const Executor &executor, const Less &less, const Input &input,
+		const Commit &commit, const Cancellation &cancellation) {
+	typedef std::decay_t<decltype(*std::begin(input->value))> value_type;
+	const auto &collection(input->value);
+	std::size_t size(collection.size());
+	std::size_t count(std::max<std::size_t>(1,
+		std::min(sort_max_buckets, size / sort_grain_size)));
+	auto buckets(std::make_shared<sort_buckets_type<value_type>>(count));
+	auto pointer_less([less](const value_type *a, const value_type *b) {
+		return less(*a, *b);
+	});
+	if (count > 1) {
+		std::vector<const value_type *> sample;
+		std::size_t samples(count * sort_oversampling);
+		for (std::size_t i = 0; i < samples; ++i) {
+			sample.push_back(&*(std::begin(collection) + i * size / samples));
+		}
+		std::sort(sample.begin(), sample.end(), pointer_less);
+		for (std::size_t i = 1; i < count; ++i) {
+			buckets->splitters.push_back(sample[i * sort_oversampling]);
+		}
+	}
+	for (std::size_t chunk = 0; chunk < count; ++chunk) {
+		internal::execute_indexed(executor, [=]() {
+			if (!cancellation.cancelled()) {
+				util::cancellation_scope_type scope(cancellation);
+				const auto &collection(input->value);
+				const auto &splitters(buckets->splitters);
+				auto &row(buckets->buckets[chunk]);
+				auto last(std::begin(collection) + (chunk + 1) * size / count);
+				for (auto it = std::begin(collection) + chunk * size / count; it != last; ++it) {
+					row[std::upper_bound(splitters.begin(), splitters.end(), &*it, pointer_less)
+						- splitters.begin()].push_back(&*it);
+				}
+			}
+			if (--buckets->pending == 0 && !cancellation.cancelled()) {
+				sort_buckets(executor, less, buckets, std::make_shared<Collector>(size), commit,
+					cancellation);
+			}
+		}, chunk, count);
+	}
+}
+
+// Merges the elements which differ from the previously sorted input into the previous output.
+// Returns false, leaving collector untouched, if more than an eighth of them changed.
+template<typename Less, typename Previous, typename Input, typename Collector>
+bool merge_sort_changes(const Less &less, const Previous &previous, const Input &input,
+		Collector &collector) {
+	typedef std::decay_t<decltype(*std::begin(input->value))> value_type;
+	const auto &before(previous.input->value);
+	const auto &after(input->value);
+	std::size_t size(std::max(before.size(), after.size()));
+	std::vector<const value_type *> removed, added;
+	auto a(std::begin(before)), b(std::begin(after));
+	for (; a != std::end(before) && b != std::end(after); ++a, ++b) {
+		if (!(*a == *b)) {
+			removed.push_back(&*a);
+			added.push_back(&*b);
+			if (removed.size() > size / 8) {
+				return false;
+			}
+		}
+	}
+	for (; a != std::end(before); ++a) {
+		removed.push_back(&*a);
+	}
+	for (; b != std::end(after); ++b) {
+		added.push_back(&*b);
+	}
+	if (removed.size() + added.size() > size / 4) {
+		return false;
+	}
+	auto pointer_less([&](const value_type *a, const value_type *b) { return less(*a, *b); });
+	std::sort(removed.begin(), removed.end(), pointer_less);
+	std::sort(added.begin(), added.end(), pointer_less);
+
+	// Every removed element is found among the equivalent elements of the previous output.
+	std::vector<bool> matched(removed.size());
+	auto next_removed(removed.begin());
+	auto next_added(added.begin());
+	std::size_t index(0);
+	for (const auto &value : previous.value) {
+		while (next_removed != removed.end() && less(**next_removed, value)) {
+			++next_removed;
+		}
+		bool skip(false);
+		for (auto it = next_removed; it != removed.end() && !less(value, **it); ++it) {
+			if (!matched[it - removed.begin()] && **it == value) {
+				matched[it - removed.begin()] = skip = true;
+				break;
+			}
+		}
+		for (; next_added != added.end() && less(**next_added, value); ++next_added) {
+			collector.construct(index++, **next_added);
+		}
+		if (!skip) {
+			collector.construct(index++, value);
+		}
+	}
+	for (; next_added != added.end(); ++next_added) {
+		collector.construct(index++, **next_added);
+	}
+	return true;
+}
+
+template<bool Incremental, std::size_t I, typename Comparator, typename Function,
+	typename... Dependencies>
+auto make_sort(Function &&function, Dependencies... dependencies) {
+	static_assert(I < sizeof...(Dependencies),
+		"sorted index must be in the range of [0, arity) where arity = number of dependencies.");
+	typedef typename util::unwrap_container_t<std::tuple_element_t<I, std::tuple<Dependencies...>>>
+		::value_type argument_container_type;
+	typedef std::decay_t<typename argument_container_type::value_type> value_type;
+	static_assert(std::is_copy_constructible<value_type>::value, "T must be copy constructible.");
+	static_assert(!Incremental || util::is_equality_comparable<value_type>::value,
+		"T must implement equality comparator");
+	typedef std::decay_t<decltype(internal::get_storage(util::unwrap_container(
+		std::declval<std::tuple_element_t<I, std::tuple<Dependencies...>>>())))> input_type;
+	typedef vector_view_type<value_type, Comparator> collector_view_type;
+	typedef details::sort_commit_storage_type<collector_view_type, input_type,
+		sizeof...(Dependencies)> commit_storage_type;
+	typedef std::array<util::revision_type, sizeof...(Dependencies)> revisions_type;
+
+	return details::make_repository<collector_view_type, commit_storage_type,
+			util::collection_comparator_t<Comparator, collector_view_type>>([
+				function = internal::get_function(util::unwrap_reference(std::forward<Function>(function))),
+				executor = internal::get_executor(util::unwrap_reference(std::forward<Function>(function)))](
+				auto &&callback, const auto &previous_storage, const auto &dependencies,
+				const auto &cancellation) {
+		typedef util::fixed_size_collector_type<value_type, Comparator> collector_type;
+
+		auto values(util::invoke([&](const auto&... dependency) {
+			return std::make_tuple(internal::get_storage(util::unwrap_container(dependency))...);
+		}, *dependencies));
+		auto revisions(util::invoke([&](const auto&... storage) {
+			return revisions_type{ storage->revision... };
+		}, values));
+		auto input(std::get<I>(values));
+		auto less([function, values](const value_type &a, const value_type &b) {
+			return sort_less<I>(function, a, b, values,
+				std::make_index_sequence<sizeof...(Dependencies) - 1>());
+		});
+		auto commit([callback, revisions, input](const auto &collector) {
+			callback(std::make_shared<commit_storage_type>(
+				collector_view_type(std::move(*collector)), util::default_revision, revisions,
+				Incremental ? input : nullptr));
+		});
+		auto previous(std::atomic_load(&*previous_storage));
+		if (input->value.empty()) {
+			commit(std::make_shared<collector_type>(0));
+		} else if (Incremental && previous && previous->input
+				&& util::tuple_le_except_index<I>(revisions, previous->revisions)) {
+			executor([=]() {
+				if (!cancellation.cancelled()) {
+					util::cancellation_scope_type scope(cancellation);
+					auto collector(std::make_shared<collector_type>(input->value.size()));
+					if (merge_sort_changes(less, *previous, input, *collector)) {
+						commit(collector);
+					} else {
+						sample_sort<collector_type>(executor, less, input, commit, cancellation);
+					}
+				}
+			});
+		} else {
+			sample_sort<collector_type>(executor, less, input, commit, cancellation);
+		}
+	}, std::forward<Dependencies>(dependencies)...);
+}
+
+} // namespace details
+
+// Sorts the collection of dependency I with function(a, b, others...), where others are the
+// values of the remaining dependencies. Large collections are sorted in parallel tasks on the
+// executor, see sample_sort.
+template<std::size_t I, typename Comparator, typename Function, typename... Dependencies>
+auto sort(Function &&function, Dependencies... dependencies) {
+	return details::make_sort<false, I, Comparator>(std::forward<Function>(function),
+		std::forward<Dependencies>(dependencies)...);
+}
+
+template<std::size_t I, typename Function, typename... Dependencies>
+auto sort(Function &&function, Dependencies... dependencies) {
+	typedef std::decay_t<typename util::unwrap_container_t<std::tuple_element_t<I,
+		std::tuple<Dependencies...>>>::value_type::value_type> value_type;
+	static_assert(util::is_equality_comparable<value_type>::value,
+		"T must implement equality comparator");
+	return push::sort<I, std::equal_to<value_type>>(std::forward<Function>(function),
+		std::forward<Dependencies>(dependencies)...);
+}
+
+template<typename Comparator, typename Function, typename Dependency>
+auto sort(Function &&function, Dependency dependency) {
+	return push::sort<0, Comparator>(std::forward<Function>(function),
+		std::forward<Dependency>(dependency));
+}
+
+template<typename Function, typename Dependency>
+auto sort(Function &&function, Dependency dependency) {
+	return push::sort<0>(std::forward<Function>(function), std::forward<Dependency>(dependency));
+}
+
+// As sort, but if only a few elements differ from the previously sorted collection, at the
+// same positions, they are merged into the previous result in linear time instead.
+template<std::size_t I, typename Comparator, typename Function, typename... Dependencies>
+auto incremental_sort(Function &&function, Dependencies... dependencies) {
+	return details::make_sort<true, I, Comparator>(std::forward<Function>(function),
+		std::forward<Dependencies>(dependencies)...);
+}
+
+template<std::size_t I, typename Function, typename... Dependencies>
+auto incremental_sort(Function &&function, Dependencies... dependencies) {
+	typedef std::decay_t<typename util::unwrap_container_t<std::tuple_element_t<I,
+		std::tuple<Dependencies...>>>::value_type::value_type> value_type;
+	return push::incremental_sort<I, std::equal_to<value_type>>(
+		std::forward<Function>(function), std::forward<Dependencies>(dependencies)...);
+}
+
+template<typename Comparator, typename Function, typename Dependency>
+auto incremental_sort(Function &&function, Dependency dependency) {
+	return push::incremental_sort<0, Comparator>(std::forward<Function>(function),
+		std::forward<Dependency>(dependency));
+}
+
+template<typename Function, typename Dependency>
+auto incremental_sort(Function &&function, Dependency dependency) {
+	return push::incremental_sort<0>(std::forward<Function>(function),
+		std::forward<Dependency>(dependency));
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_SORT_H_
@@ -13,12 +13,16 @@
 #ifndef _FRP_STATIC_PUSH_SOURCE_H_
 #define _FRP_STATIC_PUSH_SOURCE_H_
 
+#include <atomic>
+#include <frp/comparator.h>
+#include <frp/instrumentation.h>
 #include <frp/internal/namespace_alias.h>
 #include <frp/internal/operator.h>
 #include <frp/util/observable.h>
 #include <frp/util/storage.h>
 #include <memory>
 #include <stdexcept>
+#include <thread>
 
 namespace frp {
 namespace stat {
@@ -70,6 +74,8 @@ struct source_type {
 		->decltype(observable.add_callback(std::forward<F>(f)));
 	template<typename U>
 	friend auto internal::get_storage(U &value)->decltype(value.get_storage());
+	template<typename U>
+	friend auto internal::get_instrumentation(U &value)->decltype(value.get_instrumentation());
 
 	typedef T value_type;
 
@@ -97,36 +103,140 @@ private:
 		: storage(std::forward<std::unique_ptr<StorageT>>(storage)) {}
 
 	struct storage_type : util::observable_type {
+		storage_type()
+			: instrumentation(util::instrumentation_type::make<T>()), modifications(0) {
+			modifying.clear();
+		}
+
+		explicit storage_type(std::shared_ptr<util::storage_type<T>> &&value)
+			: instrumentation(util::instrumentation_type::make<T>())
+			, value(std::forward<std::shared_ptr<util::storage_type<T>>>(value))
+			, modifications(0) {
+			modifying.clear();
+			instrumentation.written(instrumentation.evaluation_started(), *this->value);
+		}
+
 		virtual void accept(std::shared_ptr<util::storage_type<T>> &&) = 0;
-		virtual std::shared_ptr<util::storage_type<T>> get() const = 0;
 		virtual ~storage_type() {}
+
+		// The value is detached while being modified, readers observing the detached state
+		// wait for the modification to complete rather than reporting a missing value.
+		std::shared_ptr<util::storage_type<T>> get() const {
+			for (;;) {
+				auto modifications(this->modifications.load());
+				auto current(std::atomic_load(&value));
+				if (current || (!(modifications & 1) && modifications == this->modifications)) {
+					return current;
+				}
+				std::this_thread::yield();
+			}
+		}
+
+		template<typename F>
+		void modify(F &&f) {
+			static_assert(std::is_copy_constructible<T>::value,
+				"T must be copy constructible.");
+			while (modifying.test_and_set(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+			++modifications;
+			auto current(std::atomic_load(&value));
+			do {
+				if (!current) {
+					++modifications;
+					modifying.clear(std::memory_order_release);
+					throw std::domain_error("value not available");
+				}
+			} while (!std::atomic_compare_exchange_weak(&value, &current,
+				std::shared_ptr<util::storage_type<T>>()));
+			auto start(instrumentation.evaluation_started());
+			bool changed(false);
+			// No reader can acquire the detached value, if nobody else holds it we are free
+			// to modify it in place. Otherwise copy-on-write.
+			bool shared(current.use_count() != 1);
+			auto replacement(current);
+			try {
+				if (shared) {
+					replacement = std::make_shared<util::storage_type<T>>(current->value,
+						current->revision);
+				}
+				changed = invoke_modify(f, replacement->value,
+					std::is_void<decltype(f(replacement->value))>());
+				if (changed) {
+					++replacement->revision;
+				} else {
+					replacement = current;
+				}
+			} catch (...) {
+				std::atomic_store(&value, std::move(current));
+				++modifications;
+				modifying.clear(std::memory_order_release);
+				throw;
+			}
+			if (changed) {
+				instrumentation.written(start, *replacement);
+			} else {
+				instrumentation.suppressed(start, *replacement);
+			}
+			std::atomic_store(&value, std::move(replacement));
+			++modifications;
+			modifying.clear(std::memory_order_release);
+			if (changed) {
+				util::observable_type::update();
+			}
+		}
+
+		util::instrumentation_type instrumentation;
+
+	protected:
+		template<typename F>
+		static bool invoke_modify(F &f, T &value, std::true_type) {
+			f(value);
+			return true;
+		}
+
+		template<typename F>
+		static bool invoke_modify(F &f, T &value, std::false_type) {
+			return bool(f(value));
+		}
+
+		std::shared_ptr<util::storage_type<T>> value; // Use atomics!
+		std::atomic_size_t modifications; // Odd while a modification is in progress.
+		std::atomic_flag modifying;
 	};
 
 	template<typename Comparator>
 	struct template_storage_type : storage_type {
 		template_storage_type() = default;
-		explicit template_storage_type(T &&value) : value(std::make_shared<util::storage_type<T>>(
-			std::forward<T>(value), util::default_revision)) {}
+		explicit template_storage_type(T &&value)
+			: storage_type(std::make_shared<util::storage_type<T>>(std::forward<T>(value),
+				util::default_revision)) {}
 		explicit template_storage_type(const T &value)
-			: value(std::make_shared<util::storage_type<T>>(value, util::default_revision)) {}
-
-		std::shared_ptr<util::storage_type<T>> get() const override final {
-			return std::atomic_load(&value);
-		}
+			: storage_type(std::make_shared<util::storage_type<T>>(value,
+				util::default_revision)) {}
 
 		void accept(std::shared_ptr<util::storage_type<T>> &&replacement) override final {
+			auto start(this->instrumentation.evaluation_started());
 			bool changed(false);
-			auto current = get();
-			do {
+			auto current(storage_type::get());
+			// Reload through get() on failure, never replace a value detached by modify.
+			while (util::is_never_equal<Comparator>::value || !current
+					|| !current->compare_value(*replacement, comparator)) {
 				replacement->revision = (current ? current->revision : util::default_revision) + 1;
-			} while ((!current || !current->compare_value(*replacement, comparator))
-				&& !(changed = std::atomic_compare_exchange_weak(&value, &current, replacement)));
+				if ((changed = std::atomic_compare_exchange_weak(&this->value, &current,
+						replacement))) {
+					break;
+				}
+				current = storage_type::get();
+			}
 			if (changed) {
+				this->instrumentation.written(start, *replacement);
 				util::observable_type::update();
+			} else {
+				this->instrumentation.suppressed(start, *replacement);
 			}
 		}
 
-		std::shared_ptr<util::storage_type<T>> value; // Use atomics!
 		Comparator comparator;
 	};
 
@@ -134,6 +244,10 @@ private:
 		return storage->get();
 	}
 
+	const auto &get_instrumentation() const {
+		return storage->instrumentation;
+	}
+
 	template<typename F>
 	auto add_callback(F &&f) const {
 		return storage->add_callback(std::forward<F>(f));
@@ -186,6 +300,14 @@ public:
 		return *this;
 	}
 
+	// Modifies the value in place if no reader holds it, otherwise modifies a copy.
+	// The comparator is not consulted, f may return false to signal that nothing changed.
+	template<typename F>
+	auto &modify(F &&f) const {
+		storage->modify(std::forward<F>(f));
+		return *this;
+	}
+
 	reference operator*() const {
 		return reference(get_storage());
 	}
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_STREAM_SOURCE_H_
+#define _FRP_STATIC_PUSH_STREAM_SOURCE_H_
+
+#include <atomic>
+#include <chrono>
+#include <frp/comparator.h>
+#include <frp/internal/namespace_alias.h>
+#include <frp/internal/operator.h>
+#include <frp/static/push/source.h>
+#include <frp/util/observable.h>
+#include <frp/util/queue.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace frp {
+namespace stat {
+namespace push {
+
+struct manual_drain_type {
+	bool operator()(std::size_t) const {
+		return false;
+	}
+};
+
+struct size_drain_type {
+	bool operator()(std::size_t pending) const {
+		return pending >= size;
+	}
+
+	std::size_t size;
+};
+
+template<typename Clock>
+struct period_drain_type {
+	typedef typename Clock::duration duration_type;
+
+	explicit period_drain_type(duration_type period)
+		: period(period), deadline(Clock::now().time_since_epoch().count()) {}
+
+	period_drain_type(const period_drain_type &policy)
+		: period(policy.period), deadline(policy.deadline.load()) {}
+
+	// Only the thread advancing the deadline triggers a drain.
+	bool operator()(std::size_t pending) const {
+		auto now(Clock::now().time_since_epoch().count());
+		auto deadline(this->deadline.load(std::memory_order_relaxed));
+		return pending > 0 && now >= deadline && this->deadline.compare_exchange_strong(deadline,
+			now + period.count(), std::memory_order_relaxed);
+	}
+
+	duration_type period;
+	mutable std::atomic<typename duration_type::rep> deadline;
+};
+
+inline auto manual_drain() {
+	return manual_drain_type();
+}
+
+inline auto size_drain(std::size_t size) {
+	return size_drain_type{ size };
+}
+
+template<typename Clock = std::chrono::steady_clock, typename Rep, typename Period>
+auto period_drain(std::chrono::duration<Rep, Period> period) {
+	return period_drain_type<Clock>(
+		std::chrono::duration_cast<typename Clock::duration>(period));
+}
+
+template<typename T, typename Policy>
+struct stream_source_type {
+
+	template<typename U, typename Policy_>
+	friend stream_source_type<U, std::decay_t<Policy_>> stream_source(std::size_t capacity,
+		Policy_ &&policy);
+	template<typename O, typename F>
+	friend auto util::add_callback(O &observable, F &&f)
+		->decltype(observable.add_callback(std::forward<F>(f)));
+	template<typename U>
+	friend auto internal::get_storage(U &value)->decltype(value.get_storage());
+	template<typename U>
+	friend auto internal::get_instrumentation(U &value)->decltype(value.get_instrumentation());
+
+	typedef std::vector<T> value_type;
+	typedef typename source_type<value_type>::reference reference;
+
+	bool try_push(T &&value) const {
+		return after_push(state->queue.push(std::forward<T>(value)));
+	}
+
+	bool try_push(const T &value) const {
+		return after_push(state->queue.push(value));
+	}
+
+	// Drains the queue on the calling thread whenever it is full.
+	void push(T &&value) const {
+		while (!try_push(std::forward<T>(value))) {
+			if (!drain()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void push(const T &value) const {
+		while (!try_push(value)) {
+			if (!drain()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	// Commits the pending elements as a single batch. Only one thread drains at any time,
+	// others return immediately since the active drain will pick up their elements.
+	std::size_t drain() const {
+		std::size_t total(0);
+		do {
+			if (state->draining.test_and_set(std::memory_order_acquire)) {
+				break;
+			}
+			value_type batch;
+			batch.reserve(state->queue.size());
+			auto count(state->queue.consume([&](T &&value) {
+				batch.push_back(std::move(value));
+			}));
+			if (count) {
+				state->source = std::move(batch);
+				total += count;
+			}
+			state->draining.clear(std::memory_order_release);
+		} while (state->policy(state->queue.size()));
+		return total;
+	}
+
+	std::size_t pending() const {
+		return state->queue.size();
+	}
+
+	reference operator*() const {
+		return *state->source;
+	}
+
+private:
+	// Every drained batch is a distinct event, even if it happens to equal the previous one.
+	struct state_type {
+		state_type(std::size_t capacity, Policy &&policy)
+			: queue(capacity)
+			, policy(std::forward<Policy>(policy))
+			, source(push::source<never_equal, value_type>()) {
+			draining.clear();
+		}
+
+		util::bounded_queue_type<T> queue;
+		Policy policy;
+		std::atomic_flag draining;
+		source_type<value_type> source;
+	};
+
+	stream_source_type(std::size_t capacity, Policy &&policy)
+		: state(std::make_unique<state_type>(capacity, std::forward<Policy>(policy))) {}
+
+	bool after_push(bool pushed) const {
+		if (pushed && state->policy(state->queue.size())) {
+			drain();
+		}
+		return pushed;
+	}
+
+	auto get_storage() const {
+		return internal::get_storage(state->source);
+	}
+
+	const auto &get_instrumentation() const {
+		return internal::get_instrumentation(state->source);
+	}
+
+	template<typename F>
+	auto add_callback(F &&f) const {
+		return util::add_callback(state->source, std::forward<F>(f));
+	}
+
+	std::unique_ptr<state_type> state;
+};
+
+template<typename T, typename Policy>
+stream_source_type<T, std::decay_t<Policy>> stream_source(std::size_t capacity,
+		Policy &&policy) {
+	static_assert(!std::is_void<T>::value, "T must not be void type.");
+	static_assert(std::is_move_constructible<T>::value, "T must be move constructible");
+	return stream_source_type<T, std::decay_t<Policy>>(capacity,
+		std::decay_t<Policy>(std::forward<Policy>(policy)));
+}
+
+template<typename T>
+auto stream_source(std::size_t capacity) {
+	return stream_source<T>(capacity, manual_drain());
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_STREAM_SOURCE_H_
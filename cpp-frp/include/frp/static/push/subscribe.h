@@ -0,0 +1,177 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_SUBSCRIBE_H_
+#define _FRP_STATIC_PUSH_SUBSCRIBE_H_
+
+#include <atomic>
+#include <frp/execute_on.h>
+#include <frp/internal/namespace_alias.h>
+#include <frp/internal/operator.h>
+#include <frp/util/observable.h>
+#include <frp/util/reference.h>
+#include <frp/util/storage.h>
+#include <memory>
+#include <mutex>
+
+namespace frp {
+namespace stat {
+namespace push {
+
+struct subscription_type;
+
+namespace details {
+
+template<typename Storage, typename Update>
+subscription_type make_subscription(const std::shared_ptr<Storage> &storage, Update update);
+
+} // namespace details
+
+struct subscription_type {
+
+	template<typename Storage, typename Update>
+	friend subscription_type details::make_subscription(const std::shared_ptr<Storage> &storage,
+		Update update);
+
+	subscription_type() = default;
+
+private:
+	subscription_type(const std::shared_ptr<void> &storage,
+		util::observable_type::reference_type &&callback)
+		: storage(storage), callback(std::move(callback)) {}
+
+	std::shared_ptr<void> storage;
+	util::observable_type::reference_type callback;
+};
+
+namespace details {
+
+template<typename Function, typename Dependency>
+struct subscribe_storage_type {
+	typedef typename util::unwrap_container_t<Dependency>::value_type value_type;
+	typedef std::shared_ptr<util::storage_type<value_type>> storage_type;
+	typedef std::decay_t<decltype(internal::get_function(
+		util::unwrap_reference(std::declval<Function>())))> function_type;
+	typedef std::decay_t<decltype(internal::get_executor(
+		util::unwrap_reference(std::declval<Function>())))> executor_type;
+
+	static_assert(!std::is_void<value_type>::value, "T must not be void type.");
+
+	subscribe_storage_type(Function &&function, Dependency &&dependency)
+		: function(internal::get_function(util::unwrap_reference(
+			std::forward<Function>(function))))
+		, executor(internal::get_executor(util::unwrap_reference(
+			std::forward<Function>(function))))
+		, dependency(std::forward<Dependency>(dependency))
+		, next_revision(0)
+		, scheduled(false) {}
+
+	auto get_storage() const {
+		return internal::get_storage(util::unwrap_container(dependency));
+	}
+
+	// Invokes function unless value is older or the same as what was already delivered.
+	// Invocations are serialized, so function never runs concurrently with itself.
+	void deliver(const storage_type &value) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (value->revision < next_revision) {
+			return;
+		}
+		next_revision = value->revision + 1;
+		function(value->value);
+	}
+
+	function_type function;
+	executor_type executor;
+	Dependency dependency;
+	std::mutex mutex;
+	util::revision_type next_revision;
+	storage_type pending; // Use atomics!
+	std::atomic_bool scheduled;
+};
+
+// Tasks only refer to storage weakly, those still queued once the subscription is destroyed
+// do nothing.
+template<typename Storage>
+void subscribe_all(const std::shared_ptr<Storage> &storage) {
+	auto value(storage->get_storage());
+	if (value) {
+		storage->executor([weak_storage = std::weak_ptr<Storage>(storage), value]() {
+			if (auto storage = weak_storage.lock()) {
+				storage->deliver(value);
+			}
+		});
+	}
+}
+
+// Only the most recent value is kept, revisions committed while the previous invocation is
+// still pending are dropped.
+template<typename Storage>
+void subscribe_latest(const std::shared_ptr<Storage> &storage) {
+	auto value(storage->get_storage());
+	if (value) {
+		std::atomic_store(&storage->pending, value);
+		if (!storage->scheduled.exchange(true)) {
+			storage->executor([weak_storage = std::weak_ptr<Storage>(storage)]() {
+				if (auto storage = weak_storage.lock()) {
+					storage->scheduled = false;
+					auto value(std::atomic_exchange(&storage->pending,
+						typename Storage::storage_type()));
+					if (value) {
+						storage->deliver(value);
+					}
+				}
+			});
+		}
+	}
+}
+
+template<typename Storage, typename Update>
+subscription_type make_subscription(const std::shared_ptr<Storage> &storage, Update update) {
+	auto callback(util::add_callback(util::unwrap_container(storage->dependency),
+		[weak_storage = std::weak_ptr<Storage>(storage), update]() {
+			auto storage(weak_storage.lock());
+			if (storage) {
+				update(storage);
+			}
+		}));
+	update(storage);
+	return subscription_type(storage, std::move(callback));
+}
+
+} // namespace details
+
+// Invokes function with every committed value of dependency, without creating a repository.
+// Invocations happen on the executor given with execute_on and stop once the returned
+// subscription is destroyed.
+template<typename Function, typename Dependency>
+subscription_type subscribe(Function &&function, Dependency dependency) {
+	typedef details::subscribe_storage_type<Function, Dependency> storage_type;
+	return details::make_subscription(std::make_shared<storage_type>(
+		std::forward<Function>(function), std::forward<Dependency>(dependency)),
+		&details::subscribe_all<storage_type>);
+}
+
+// Like subscribe, but skips values committed while function is still pending on the executor.
+template<typename Function, typename Dependency>
+subscription_type subscribe_latest(Function &&function, Dependency dependency) {
+	typedef details::subscribe_storage_type<Function, Dependency> storage_type;
+	return details::make_subscription(std::make_shared<storage_type>(
+		std::forward<Function>(function), std::forward<Dependency>(dependency)),
+		&details::subscribe_latest<storage_type>);
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_SUBSCRIBE_H_
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_THROTTLE_H_
+#define _FRP_STATIC_PUSH_THROTTLE_H_
+
+#include <chrono>
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/repository.h>
+#include <frp/timer_wheel.h>
+#include <memory>
+#include <mutex>
+
+namespace frp {
+namespace stat {
+namespace push {
+namespace details {
+
+template<typename T, typename Wheel, typename Dependency>
+struct timed_state_type {
+	typedef T value_type;
+	typedef typename Wheel::duration duration;
+	typedef typename Wheel::time_point time_point;
+
+	timed_state_type(Wheel &wheel, duration period, Dependency &&dependency)
+		: wheel(wheel)
+		, period(period)
+		, dependency(std::forward<Dependency>(dependency))
+		, forwarder(std::make_shared<forwarder_type<T>>())
+		, instrumentation(util::instrumentation_type::make<T>(
+			internal::get_instrumentation(util::unwrap_container(this->dependency))))
+		, scheduled(false) {}
+
+	// The latest value committed by the dependency.
+	void forward() {
+		auto start(instrumentation.evaluation_started());
+		auto value(internal::get_storage(util::unwrap_container(dependency)));
+		if (forwarder->forward(value)) {
+			instrumentation.committed(start, *value);
+		}
+	}
+
+	template<typename State, typename F>
+	static void subscribe(const std::shared_ptr<State> &state, F &&f) {
+		state->callback = util::add_callback(util::unwrap_container(state->dependency),
+			[weak_state = std::weak_ptr<State>(state), f]() {
+				if (auto state = weak_state.lock()) {
+					f(*state, weak_state);
+				}
+			});
+	}
+
+	Wheel &wheel;
+	const duration period;
+	Dependency dependency;
+	std::shared_ptr<forwarder_type<T>> forwarder;
+	util::instrumentation_type instrumentation;
+	util::observable_type::reference_type callback;
+	std::mutex mutex;
+	time_point last;
+	bool scheduled;
+};
+
+template<typename State>
+repository_type<typename State::value_type> make_timed_repository(
+		const std::shared_ptr<State> &state) {
+	return make_forwarding_repository<typename State::value_type>(state, state->forwarder,
+		state->instrumentation);
+}
+
+} // namespace details
+
+// Forwards the first commit of dependency right away, later ones at most once per period.
+// Commits in between are collapsed into the latest, forwarded once the period has passed.
+template<typename Clock, typename Rep, typename Period, typename Dependency>
+auto throttle(timer_wheel_type<Clock> &wheel, std::chrono::duration<Rep, Period> period,
+		Dependency dependency) {
+	typedef typename util::unwrap_container_t<Dependency>::value_type value_type;
+	typedef details::timed_state_type<value_type, timer_wheel_type<Clock>, Dependency>
+		state_type;
+	auto state(std::make_shared<state_type>(wheel,
+		std::chrono::duration_cast<typename Clock::duration>(period),
+		std::forward<Dependency>(dependency)));
+	state_type::subscribe(state, [](state_type &state, const std::weak_ptr<state_type> &weak) {
+		std::unique_lock<std::mutex> lock(state.mutex);
+		if (state.scheduled) {
+			return;
+		}
+		auto now(state.wheel.now());
+		if (now - state.last >= state.period) {
+			state.last = now;
+			lock.unlock();
+			state.forward();
+		} else {
+			state.scheduled = true;
+			state.wheel.schedule(state.last + state.period, [weak]() {
+				if (auto state = weak.lock()) {
+					{
+						std::lock_guard<std::mutex> lock(state->mutex);
+						state->scheduled = false;
+						state->last = state->wheel.now();
+					}
+					state->forward();
+				}
+			});
+		}
+	});
+	state->last = wheel.now();
+	state->forward();
+	return details::make_timed_repository(state);
+}
+
+template<typename Rep, typename Period, typename Dependency>
+auto throttle(std::chrono::duration<Rep, Period> period, Dependency dependency) {
+	return push::throttle(default_timer_wheel(), period, std::forward<Dependency>(dependency));
+}
+
+// Forwards the latest commit of dependency once it has not committed for quiet.
+template<typename Clock, typename Rep, typename Period, typename Dependency>
+auto debounce(timer_wheel_type<Clock> &wheel, std::chrono::duration<Rep, Period> quiet,
+		Dependency dependency) {
+	typedef typename util::unwrap_container_t<Dependency>::value_type value_type;
+	typedef timer_wheel_type<Clock> wheel_type;
+	struct state_type : details::timed_state_type<value_type, wheel_type, Dependency> {
+		using details::timed_state_type<value_type, wheel_type, Dependency>::timed_state_type;
+
+		// A single timer is pending at any time, it is rescheduled if commits arrived since.
+		static void expire(const std::weak_ptr<state_type> &weak) {
+			if (auto state = weak.lock()) {
+				std::unique_lock<std::mutex> lock(state->mutex);
+				auto deadline(state->last + state->period);
+				if (state->wheel.now() < deadline) {
+					state->wheel.schedule(deadline, [weak]() { expire(weak); });
+				} else {
+					state->scheduled = false;
+					lock.unlock();
+					state->forward();
+				}
+			}
+		}
+	};
+	auto state(std::make_shared<state_type>(wheel,
+		std::chrono::duration_cast<typename Clock::duration>(quiet),
+		std::forward<Dependency>(dependency)));
+	state_type::subscribe(state, [](state_type &state, const std::weak_ptr<state_type> &weak) {
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.last = state.wheel.now();
+		if (!state.scheduled) {
+			state.scheduled = true;
+			state.wheel.schedule(state.last + state.period, [weak]() {
+				state_type::expire(weak);
+			});
+		}
+	});
+	state->forward();
+	return details::make_timed_repository(state);
+}
+
+template<typename Rep, typename Period, typename Dependency>
+auto debounce(std::chrono::duration<Rep, Period> quiet, Dependency dependency) {
+	return push::debounce(default_timer_wheel(), quiet, std::forward<Dependency>(dependency));
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_THROTTLE_H_
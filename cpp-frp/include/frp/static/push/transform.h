@@ -20,21 +20,22 @@ namespace frp {
 namespace stat {
 namespace push {
 
-template<typename Comparator, typename Function, typename... Dependencies>
-auto transform(Function &&function, Dependencies... dependencies) {
-	static_assert(util::all_true_type<typename util::is_not_void<
-		typename util::unwrap_container_t<Dependencies>::value_type>::type...>::value,
-		"Dependencies can not be void type.");
+namespace details {
 
-	typedef util::transform_return_type<Function, Dependencies...> value_type;
-	typedef util::commit_storage_type<value_type, sizeof...(Dependencies)> commit_storage_type;
-	typedef typename commit_storage_type::revisions_type revisions_type;
+// Evaluates function with the values of the dependencies and commits the result as Storage.
+template<typename T, typename Storage, typename Comparator, typename Function,
+	typename... Dependencies>
+auto make_transform(Function &&function, Dependencies... dependencies) {
+	typedef typename Storage::revisions_type revisions_type;
 
-	return details::make_repository<value_type, commit_storage_type, Comparator>(
+	return details::make_repository<T, Storage, Comparator>(
 		[function = internal::get_function(util::unwrap_reference(std::forward<Function>(function))),
 		 executor = internal::get_executor(util::unwrap_reference(std::forward<Function>(function)))](
-			auto &&callback, const auto &previous, const auto &storage) {
+			auto &&callback, const auto &previous, const auto &storage, const auto &cancellation) {
 		executor([=, callback = std::move(callback)]() {
+			if (cancellation.cancelled()) {
+				return;
+			}
 			auto current(util::invoke([&](const auto&... storage) {
 				return std::make_tuple(internal::get_storage(util::unwrap_container(storage))...);
 			}, *storage));
@@ -45,7 +46,8 @@ auto transform(Function &&function, Dependencies... dependencies) {
 			if (!last || last->is_newer(revisions)) {
 				callback(util::invoke([&](const auto&... storage) {
 					revisions_type revisions{ storage->revision... };
-					return commit_storage_type::make(std::bind(std::ref(function),
+					util::cancellation_scope_type scope(cancellation);
+					return Storage::make(std::bind(std::ref(function),
 						std::cref(storage->value)...), revisions);
 				}, current));
 			}
@@ -53,10 +55,25 @@ auto transform(Function &&function, Dependencies... dependencies) {
 	}, std::forward<Dependencies>(dependencies)...);
 }
 
+} // namespace details
+
+template<typename Comparator, typename Function, typename... Dependencies>
+auto transform(Function &&function, Dependencies... dependencies) {
+	static_assert(util::all_true_type<typename util::is_not_void<
+		typename util::unwrap_container_t<Dependencies>::value_type>::type...>::value,
+		"Dependencies can not be void type.");
+
+	typedef util::transform_return_type<Function, Dependencies...> value_type;
+	typedef util::commit_storage_type<value_type, sizeof...(Dependencies)> commit_storage_type;
+
+	return details::make_transform<value_type, commit_storage_type, Comparator>(
+		std::forward<Function>(function), std::forward<Dependencies>(dependencies)...);
+}
+
 template<typename Function, typename... Dependencies>
 auto transform(Function &&function, Dependencies... dependencies) {
 	typedef util::transform_return_type<Function, Dependencies...> value_type;
-	return transform<std::equal_to<value_type>, Function, Dependencies...>(
+	return push::transform<std::equal_to<value_type>, Function, Dependencies...>(
 		std::forward<Function>(function), std::forward<Dependencies>(dependencies)...);
 }
 
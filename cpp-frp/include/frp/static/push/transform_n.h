@@ -0,0 +1,179 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_TRANSFORM_N_H_
+#define _FRP_STATIC_PUSH_TRANSFORM_N_H_
+
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/repository.h>
+#include <frp/static/push/transform.h>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+namespace frp {
+namespace stat {
+namespace push {
+namespace details {
+
+// One output of transform_n, stored within the value of the shared evaluation. Its revision is
+// assigned before the shared value is committed and never written once it is published.
+template<typename T>
+struct transform_n_output_storage_type : util::storage_type<T> {
+	explicit transform_n_output_storage_type(T &&value)
+		: util::storage_type<T>(std::forward<T>(value), util::default_revision + 1) {}
+};
+
+template<typename Comparators, std::size_t DependenciesN, typename... Ts>
+struct transform_n_storage_type : util::commit_storage_type<
+		std::tuple<transform_n_output_storage_type<Ts>...>, DependenciesN> {
+	typedef std::tuple<transform_n_output_storage_type<Ts>...> value_type;
+	typedef util::commit_storage_type<value_type, DependenciesN> parent_type;
+	typedef typename parent_type::revisions_type revisions_type;
+
+	template<typename F>
+	static auto make(F &&function, const revisions_type &revisions) {
+		return std::make_shared<transform_n_storage_type>(function(), revisions);
+	}
+
+	transform_n_storage_type(std::tuple<Ts...> &&values, const revisions_type &revisions)
+		: parent_type(value_type(std::move(values)), util::default_revision, revisions) {}
+
+	// Invoked by submit_commit once the revision of this evaluation is known. Equal only if every
+	// output compares equal, so that the outputs are not even evaluated otherwise.
+	template<typename Comparator>
+	bool compare_value(transform_n_storage_type &previous, const Comparator &) {
+		return compare_outputs(previous, std::index_sequence_for<Ts...>());
+	}
+
+private:
+	template<std::size_t... Is>
+	bool compare_outputs(transform_n_storage_type &previous, std::index_sequence<Is...>) {
+		bool equals(true);
+		for (auto output : { compare_output<Is>(previous)... }) {
+			equals = equals && output;
+		}
+		return equals;
+	}
+
+	// An output equal to the previous one keeps its revision, so it is not forwarded again.
+	template<std::size_t I>
+	bool compare_output(transform_n_storage_type &previous) {
+		auto &output(std::get<I>(this->value));
+		const auto &previous_output(std::get<I>(previous.value));
+		bool equals(std::tuple_element_t<I, Comparators>()(output.value, previous_output.value));
+		output.revision = previous_output.revision + (equals ? 0 : 1);
+		return equals;
+	}
+};
+
+// Forwards an aliasing pointer to its output within the shared value, nothing is copied.
+template<std::size_t I, typename T, typename Shared>
+struct transform_n_output_state_type {
+	typedef T value_type;
+
+	explicit transform_n_output_state_type(const std::shared_ptr<Shared> &shared)
+		: shared(shared)
+		, forwarder(std::make_shared<forwarder_type<value_type>>())
+		, instrumentation(util::instrumentation_type::make<value_type>(
+			internal::get_instrumentation(*shared))) {}
+
+	// Outputs which compared equal kept their revision and are ignored by the forwarder.
+	void forward() {
+		auto start(instrumentation.evaluation_started());
+		auto value(internal::get_storage(*shared));
+		if (value) {
+			auto &output(std::get<I>(value->value));
+			forwarder->forward(std::shared_ptr<util::storage_type<value_type>>(value, &output));
+			instrumentation.committed(start, output);
+		}
+	}
+
+	std::shared_ptr<Shared> shared;
+	std::shared_ptr<forwarder_type<value_type>> forwarder;
+	util::instrumentation_type instrumentation;
+	util::observable_type::reference_type callback;
+};
+
+template<std::size_t I, typename T, typename Shared>
+repository_type<T> make_transform_n_output(const std::shared_ptr<Shared> &shared) {
+	typedef transform_n_output_state_type<I, T, Shared> state_type;
+	auto state(std::make_shared<state_type>(shared));
+	state->callback = util::add_callback(*shared,
+		[weak_state = std::weak_ptr<state_type>(state)]() {
+			if (auto state = weak_state.lock()) {
+				state->forward();
+			}
+		});
+	state->forward();
+	return make_forwarding_repository<T>(state, state->forwarder, state->instrumentation);
+}
+
+template<typename Comparators, typename T>
+struct transform_n_type {
+	static_assert(sizeof(T) == 0, "Function must return a std::tuple.");
+};
+
+template<typename Comparators, typename... Ts>
+struct transform_n_type<Comparators, std::tuple<Ts...>> {
+	static_assert(std::tuple_size<Comparators>::value == sizeof...(Ts),
+		"There must be one comparator per output.");
+
+	template<typename Function, typename... Dependencies>
+	static auto make(Function &&function, Dependencies &&... dependencies) {
+		typedef transform_n_storage_type<Comparators, sizeof...(Dependencies), Ts...>
+			storage_type;
+		typedef repository_type<typename storage_type::value_type> shared_type;
+		auto shared(std::make_shared<shared_type>(
+			make_transform<typename storage_type::value_type, storage_type, Comparators>(
+				std::forward<Function>(function), std::forward<Dependencies>(dependencies)...)));
+		return make_outputs(shared, std::index_sequence_for<Ts...>());
+	}
+
+private:
+	template<typename Shared, std::size_t... Is>
+	static auto make_outputs(const Shared &shared, std::index_sequence<Is...>) {
+		return std::make_tuple(make_transform_n_output<Is, Ts>(shared)...);
+	}
+};
+
+template<typename T>
+struct transform_n_comparators_type;
+
+template<typename... Ts>
+struct transform_n_comparators_type<std::tuple<Ts...>> {
+	typedef std::tuple<std::equal_to<Ts>...> type;
+};
+
+} // namespace details
+
+// Evaluates function once per change and returns a std::tuple of repositories, one per element
+// of the std::tuple it returns. Dependents of an output that compares equal are not woken.
+template<typename Comparators, typename Function, typename... Dependencies>
+auto transform_n(Function &&function, Dependencies... dependencies) {
+	typedef std::decay_t<util::transform_return_type<Function, Dependencies...>> value_type;
+	return details::transform_n_type<Comparators, value_type>::make(
+		std::forward<Function>(function), std::forward<Dependencies>(dependencies)...);
+}
+
+template<typename Function, typename... Dependencies>
+auto transform_n(Function &&function, Dependencies... dependencies) {
+	typedef std::decay_t<util::transform_return_type<Function, Dependencies...>> value_type;
+	return push::transform_n<typename details::transform_n_comparators_type<value_type>::type>(
+		std::forward<Function>(function), std::forward<Dependencies>(dependencies)...);
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_TRANSFORM_N_H_
@@ -0,0 +1,304 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_PUSH_WINDOW_H_
+#define _FRP_STATIC_PUSH_WINDOW_H_
+
+#include <cassert>
+#include <chrono>
+#include <frp/internal/namespace_alias.h>
+#include <frp/static/push/repository.h>
+#include <frp/window.h>
+#include <memory>
+#include <mutex>
+
+namespace frp {
+namespace stat {
+namespace push {
+namespace details {
+
+template<typename Dependency>
+using window_element_t = typename util::unwrap_container_t<Dependency>::value_type::value_type;
+
+template<typename Aggregate, typename Dependency>
+using window_aggregate_t = util::window_value_t<Aggregate, window_element_t<Dependency>>;
+
+template<typename Aggregate, typename Dependency>
+struct sliding_count_window_type {
+	typedef window_aggregate_t<Aggregate, Dependency> value_type;
+
+	sliding_count_window_type(std::size_t count, const Aggregate &aggregate)
+		: count(count), aggregate(aggregate), window(aggregate) {
+		assert(count > 0);
+	}
+
+	template<typename T>
+	bool push(const T &element) {
+		if (window.size() == count) {
+			window.pop();
+		}
+		window.push(aggregate.lift(element));
+		return true;
+	}
+
+	value_type get() const {
+		return window.get();
+	}
+
+	const std::size_t count;
+	Aggregate aggregate;
+	util::window_t<Aggregate, value_type> window;
+};
+
+template<typename Duration, typename TimeOf, typename Aggregate, typename Dependency>
+struct sliding_time_window_type {
+	typedef window_aggregate_t<Aggregate, Dependency> value_type;
+	typedef std::decay_t<decltype(std::declval<TimeOf>()(
+		std::declval<const window_element_t<Dependency> &>()))> time_point;
+
+	sliding_time_window_type(Duration period, TimeOf &&time_of, const Aggregate &aggregate)
+		: period(period), time_of(std::forward<TimeOf>(time_of)), aggregate(aggregate)
+		, window(aggregate) {}
+
+	// Elements are expected in time order, the window ends at the newest one.
+	template<typename T>
+	bool push(const T &element) {
+		auto time(time_of(element));
+		while (!times.empty() && times.front() + period <= time) {
+			times.pop_front();
+			window.pop();
+		}
+		times.push_back(std::move(time));
+		window.push(aggregate.lift(element));
+		return true;
+	}
+
+	value_type get() const {
+		return window.get();
+	}
+
+	const Duration period;
+	TimeOf time_of;
+	Aggregate aggregate;
+	util::ring_buffer_type<time_point> times;
+	util::window_t<Aggregate, value_type> window;
+};
+
+// Only the aggregate of the window being filled is kept, the last completed one is committed.
+template<typename Aggregate, typename Dependency>
+struct tumbling_count_window_type {
+	typedef window_aggregate_t<Aggregate, Dependency> value_type;
+
+	tumbling_count_window_type(std::size_t count, const Aggregate &aggregate)
+		: count(count), aggregate(aggregate), size(0) {
+		assert(count > 0);
+	}
+
+	template<typename T>
+	bool push(const T &element) {
+		current = size++ == 0 ? aggregate.lift(element)
+			: aggregate.combine(current, aggregate.lift(element));
+		if (size == count) {
+			size = 0;
+			completed = std::move(current);
+			return true;
+		}
+		return false;
+	}
+
+	value_type get() const {
+		return completed;
+	}
+
+	const std::size_t count;
+	Aggregate aggregate;
+	std::size_t size;
+	value_type current;
+	value_type completed;
+};
+
+// Windows are aligned to multiples of period since the epoch of the time_point. A window is
+// completed by the first element of a later window.
+template<typename Duration, typename TimeOf, typename Aggregate, typename Dependency>
+struct tumbling_time_window_type {
+	typedef window_aggregate_t<Aggregate, Dependency> value_type;
+
+	tumbling_time_window_type(Duration period, TimeOf &&time_of, const Aggregate &aggregate)
+		: period(period), time_of(std::forward<TimeOf>(time_of)), aggregate(aggregate)
+		, empty(true) {}
+
+	template<typename T>
+	bool push(const T &element) {
+		auto index(time_of(element).time_since_epoch() / period);
+		bool complete(!empty && index > this->index);
+		if (complete) {
+			completed = std::move(current);
+			empty = true;
+		}
+		current = empty ? aggregate.lift(element)
+			: aggregate.combine(current, aggregate.lift(element));
+		if (empty) {
+			this->index = index;
+			empty = false;
+		}
+		return complete;
+	}
+
+	value_type get() const {
+		return completed;
+	}
+
+	const Duration period;
+	TimeOf time_of;
+	Aggregate aggregate;
+	bool empty;
+	decltype(std::declval<TimeOf>()(std::declval<const window_element_t<Dependency> &>())
+		.time_since_epoch() / std::declval<Duration>()) index;
+	value_type current;
+	value_type completed;
+};
+
+template<typename Window>
+struct window_state_type {
+	template<typename... Args>
+	window_state_type(Args &&... args) : window(std::forward<Args>(args)...), next_revision(0) {}
+
+	Window window;
+	util::revision_type next_revision;
+	std::mutex mutex;
+};
+
+// Every element of every committed collection is pushed to window exactly once. Collections
+// committed concurrently are pushed in revision order, and older ones arriving late are
+// dropped, as is anything committed while the repository was not observed.
+template<typename Comparator, typename Window, typename Dependency>
+auto make_window(std::shared_ptr<window_state_type<Window>> &&state, Dependency &&dependency) {
+	typedef typename Window::value_type value_type;
+	typedef util::commit_storage_type<value_type, 1> commit_storage_type;
+	static_assert(std::is_default_constructible<value_type>::value,
+		"Aggregate must be default constructible");
+	return make_repository<value_type, commit_storage_type, Comparator>(
+		[state = std::move(state)](auto &&callback, const auto &, const auto &dependencies,
+			const auto &) {
+		auto storage(internal::get_storage(util::unwrap_container(std::get<0>(*dependencies))));
+		std::unique_lock<std::mutex> lock(state->mutex);
+		if (storage->revision < state->next_revision) {
+			return;
+		}
+		state->next_revision = storage->revision + 1;
+		bool changed(false);
+		for (const auto &element : storage->value) {
+			changed = state->window.push(element) || changed;
+		}
+		if (changed) {
+			auto value(state->window.get());
+			lock.unlock();
+			callback(std::make_shared<commit_storage_type>(std::move(value),
+				util::default_revision, typename commit_storage_type::revisions_type{
+					storage->revision }));
+		}
+	}, std::forward<Dependency>(dependency));
+}
+
+template<typename Window, typename... Args>
+auto make_window_state(Args &&... args) {
+	return std::make_shared<window_state_type<Window>>(std::forward<Args>(args)...);
+}
+
+} // namespace details
+
+// Aggregates the last count elements of the collections committed by dependency, such as the
+// batches of a stream_source, and commits the aggregate once per collection. count must be
+// positive.
+template<typename Comparator, typename Aggregate, typename Dependency>
+auto sliding_window(std::size_t count, Aggregate aggregate, Dependency dependency) {
+	typedef details::sliding_count_window_type<Aggregate, Dependency> window_type;
+	return details::make_window<Comparator>(details::make_window_state<window_type>(count,
+		aggregate), std::forward<Dependency>(dependency));
+}
+
+template<typename Aggregate, typename Dependency>
+auto sliding_window(std::size_t count, Aggregate aggregate, Dependency dependency) {
+	typedef details::window_aggregate_t<Aggregate, Dependency> value_type;
+	static_assert(util::is_equality_comparable<value_type>::value,
+		"T must implement equality comparator");
+	return push::sliding_window<std::equal_to<value_type>>(count, std::move(aggregate),
+		std::forward<Dependency>(dependency));
+}
+
+// Aggregates the elements whose time_of(element) is within period of the newest element.
+template<typename Comparator, typename Rep, typename Period, typename TimeOf,
+	typename Aggregate, typename Dependency>
+auto sliding_window(std::chrono::duration<Rep, Period> period, TimeOf time_of,
+		Aggregate aggregate, Dependency dependency) {
+	typedef details::sliding_time_window_type<std::chrono::duration<Rep, Period>, TimeOf,
+		Aggregate, Dependency> window_type;
+	return details::make_window<Comparator>(details::make_window_state<window_type>(period,
+		std::move(time_of), aggregate), std::forward<Dependency>(dependency));
+}
+
+template<typename Rep, typename Period, typename TimeOf, typename Aggregate,
+	typename Dependency>
+auto sliding_window(std::chrono::duration<Rep, Period> period, TimeOf time_of,
+		Aggregate aggregate, Dependency dependency) {
+	typedef details::window_aggregate_t<Aggregate, Dependency> value_type;
+	static_assert(util::is_equality_comparable<value_type>::value,
+		"T must implement equality comparator");
+	return push::sliding_window<std::equal_to<value_type>>(period, std::move(time_of),
+		std::move(aggregate), std::forward<Dependency>(dependency));
+}
+
+// Aggregates consecutive, non-overlapping, blocks of count elements. Commits once a block is
+// complete. count must be positive.
+template<typename Comparator, typename Aggregate, typename Dependency>
+auto tumbling_window(std::size_t count, Aggregate aggregate, Dependency dependency) {
+	typedef details::tumbling_count_window_type<Aggregate, Dependency> window_type;
+	return details::make_window<Comparator>(details::make_window_state<window_type>(count,
+		aggregate), std::forward<Dependency>(dependency));
+}
+
+template<typename Aggregate, typename Dependency>
+auto tumbling_window(std::size_t count, Aggregate aggregate, Dependency dependency) {
+	typedef details::window_aggregate_t<Aggregate, Dependency> value_type;
+	static_assert(util::is_equality_comparable<value_type>::value,
+		"T must implement equality comparator");
+	return push::tumbling_window<std::equal_to<value_type>>(count, std::move(aggregate),
+		std::forward<Dependency>(dependency));
+}
+
+// Aggregates consecutive periods by time_of(element). Commits once a period is complete.
+template<typename Comparator, typename Rep, typename Period, typename TimeOf,
+	typename Aggregate, typename Dependency>
+auto tumbling_window(std::chrono::duration<Rep, Period> period, TimeOf time_of,
+		Aggregate aggregate, Dependency dependency) {
+	typedef details::tumbling_time_window_type<std::chrono::duration<Rep, Period>, TimeOf,
+		Aggregate, Dependency> window_type;
+	return details::make_window<Comparator>(details::make_window_state<window_type>(period,
+		std::move(time_of), aggregate), std::forward<Dependency>(dependency));
+}
+
+template<typename Rep, typename Period, typename TimeOf, typename Aggregate,
+	typename Dependency>
+auto tumbling_window(std::chrono::duration<Rep, Period> period, TimeOf time_of,
+		Aggregate aggregate, Dependency dependency) {
+	typedef details::window_aggregate_t<Aggregate, Dependency> value_type;
+	static_assert(util::is_equality_comparable<value_type>::value,
+		"T must implement equality comparator");
+	return push::tumbling_window<std::equal_to<value_type>>(period, std::move(time_of),
+		std::move(aggregate), std::forward<Dependency>(dependency));
+}
+
+} // namespace push
+} // namespace stat
+} // namespace frp
+
+#endif // _FRP_STATIC_PUSH_WINDOW_H_
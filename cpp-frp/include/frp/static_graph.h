@@ -0,0 +1,238 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_STATIC_GRAPH_H_
+#define _FRP_STATIC_GRAPH_H_
+
+#include <bitset>
+#include <frp/util/storage.h>
+#include <frp/util/variadic.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace frp {
+namespace graph {
+
+template<typename T>
+struct input_type {
+	typedef T value_type;
+
+	T value;
+};
+
+// Computed from the nodes at the given indices, which must precede it.
+template<typename F, std::size_t... Is>
+struct node_type {
+	F function;
+};
+
+template<typename T>
+input_type<T> input() {
+	return { T() };
+}
+
+template<typename T>
+input_type<std::decay_t<T>> input(T &&value) {
+	return { std::forward<T>(value) };
+}
+
+template<std::size_t... Is, typename F>
+node_type<std::decay_t<F>, Is...> node(F &&function) {
+	return { std::forward<F>(function) };
+}
+
+} // namespace graph
+
+namespace details {
+
+template<typename Nodes, std::size_t I, typename Node = std::tuple_element_t<I, Nodes>>
+struct static_node_value_type;
+
+template<typename Nodes, std::size_t I>
+using static_node_value_t = typename static_node_value_type<Nodes, I>::type;
+
+template<typename Nodes, std::size_t I, typename T>
+struct static_node_value_type<Nodes, I, graph::input_type<T>> {
+	typedef T type;
+};
+
+template<typename Nodes, std::size_t I, typename F, std::size_t... Is>
+struct static_node_value_type<Nodes, I, graph::node_type<F, Is...>> {
+	static_assert(util::all_true_type<std::integral_constant<bool, (Is < I)>...>::value,
+		"A node may only depend on nodes declared before it.");
+	typedef std::decay_t<std::result_of_t<const F &(const static_node_value_t<Nodes, Is> &...)>>
+		type;
+	static_assert(!std::is_void<type>::value, "T must not be void type.");
+	static_assert(std::is_move_assignable<type>::value, "T must be move assignable");
+};
+
+template<typename T>
+bool static_changed(const T &previous, const T &current, std::true_type) {
+	return !(previous == current);
+}
+
+template<typename T>
+bool static_changed(const T &, const T &, std::false_type) {
+	return true;
+}
+
+// Values without equality comparator always propagate.
+template<typename T>
+bool static_changed(const T &previous, const T &current) {
+	return static_changed(previous, current, util::is_equality_comparable<T>());
+}
+
+template<typename Nodes>
+struct static_empty_layer_type {
+	explicit static_empty_layer_type(const Nodes &) {}
+};
+
+template<typename Nodes, std::size_t I, typename Base>
+struct static_layer_type;
+
+template<typename Nodes, std::size_t N>
+struct static_layers_type {
+	typedef static_layer_type<Nodes, N - 1, typename static_layers_type<Nodes, N - 1>::type> type;
+};
+
+template<typename Nodes>
+struct static_layers_type<Nodes, 0> {
+	typedef static_empty_layer_type<Nodes> type;
+};
+
+template<typename Nodes, std::size_t I>
+using static_layer_t = typename static_layers_type<Nodes, I + 1>::type;
+
+template<std::size_t I, typename Nodes, typename Layers>
+const auto &static_value(const Layers &layers) {
+	return static_cast<const static_layer_t<Nodes, I> &>(layers).value;
+}
+
+template<typename Nodes, typename Layers, typename T>
+const T &static_evaluate(const graph::input_type<T> &input, const Layers &) {
+	return input.value;
+}
+
+template<typename Nodes, typename Layers, typename F, std::size_t... Is>
+auto static_evaluate(const graph::node_type<F, Is...> &node, const Layers &layers) {
+	return node.function(static_value<Is, Nodes>(layers)...);
+}
+
+// Every node value is stored by value in a base class of its dependents, so it can be
+// constructed from the ones before it without requiring default construction.
+template<typename Nodes, std::size_t I, typename Base>
+struct static_layer_type : Base {
+	explicit static_layer_type(const Nodes &nodes)
+		: Base(nodes), value(static_evaluate<Nodes>(std::get<I>(nodes), *this)) {}
+
+	static_node_value_t<Nodes, I> value;
+};
+
+template<typename T>
+struct is_input : std::false_type {};
+
+template<typename T>
+struct is_input<graph::input_type<T>> : std::true_type {};
+
+template<std::size_t N, typename... Is>
+bool any_changed(const std::bitset<N> &changed, Is... is) {
+	// The leading false keeps the array valid for nodes without dependencies.
+	const bool dependencies[] = { false, changed[std::size_t(is)]... };
+	bool any(false);
+	for (auto dependency : dependencies) {
+		any = any || dependency;
+	}
+	return any;
+}
+
+} // namespace details
+
+// A graph whose topology is known at compile time. Nodes are stored by value and an update is
+// propagated by direct calls in declaration order, so the compiler can inline across nodes.
+// Unlike repositories it is not thread-safe and is evaluated on the calling thread.
+template<typename... Nodes>
+struct static_graph_type {
+	typedef std::tuple<Nodes...> nodes_type;
+	static constexpr std::size_t size = sizeof...(Nodes);
+
+	template<std::size_t I>
+	using value_type = details::static_node_value_t<nodes_type, I>;
+
+	explicit static_graph_type(Nodes &&... nodes)
+		: nodes(std::forward<Nodes>(nodes)...), layers(this->nodes) {}
+
+	template<std::size_t I>
+	const value_type<I> &get() const {
+		return details::static_value<I, nodes_type>(layers);
+	}
+
+	// Recomputes the dependents of input I that are affected, nodes whose value compares equal
+	// to the previous one stop the propagation.
+	template<std::size_t I, typename T>
+	void set(T &&value) {
+		static_assert(details::is_input<std::tuple_element_t<I, nodes_type>>::value,
+			"Only inputs can be set.");
+		std::bitset<size> changed;
+		if (assign<I>(value_type<I>(std::forward<T>(value)))) {
+			changed[I] = true;
+			propagate<I + 1>(changed);
+		}
+	}
+
+private:
+	typedef typename details::static_layers_type<nodes_type, size>::type layers_type;
+
+	template<std::size_t I>
+	bool assign(value_type<I> &&value) {
+		auto &current(static_cast<details::static_layer_t<nodes_type, I> &>(layers).value);
+		if (!details::static_changed(current, value)) {
+			return false;
+		}
+		current = std::move(value);
+		return true;
+	}
+
+	template<std::size_t I>
+	std::enable_if_t<I == size> propagate(std::bitset<size> &) {}
+
+	template<std::size_t I>
+	std::enable_if_t<I < size> propagate(std::bitset<size> &changed) {
+		if (recompute<I>(std::get<I>(nodes), changed)) {
+			changed[I] = true;
+		}
+		propagate<I + 1>(changed);
+	}
+
+	template<std::size_t I, typename T>
+	bool recompute(const graph::input_type<T> &, const std::bitset<size> &) {
+		return false;
+	}
+
+	template<std::size_t I, typename F, std::size_t... Is>
+	bool recompute(const graph::node_type<F, Is...> &node, const std::bitset<size> &changed) {
+		return details::any_changed(changed, Is...)
+			&& assign<I>(details::static_evaluate<nodes_type>(node, layers));
+	}
+
+	nodes_type nodes;
+	layers_type layers;
+};
+
+template<typename... Nodes>
+static_graph_type<Nodes...> make_static_graph(Nodes... nodes) {
+	return static_graph_type<Nodes...>(std::move(nodes)...);
+}
+
+} // namespace frp
+
+#endif // _FRP_STATIC_GRAPH_H_
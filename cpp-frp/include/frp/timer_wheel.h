@@ -0,0 +1,231 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_TIMER_WHEEL_H_
+#define _FRP_TIMER_WHEEL_H_
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace frp {
+
+// Hierarchical timer wheel. Level l has slots of 64^l ticks each, timers are placed on the
+// coarsest level that still separates them from the current tick and move down a level each
+// time their slot comes up. Scheduling and expiring are constant time regardless of how many
+// timers are pending.
+//
+// Time only moves when advance() is called, either by the thread started with start() or
+// manually with any time_point, which makes operators using it testable without sleeping.
+// The started thread sleeps between timers, so now() then follows Clock::now() instead.
+template<typename Clock = std::chrono::steady_clock>
+struct timer_wheel_type {
+	typedef Clock clock_type;
+	typedef typename Clock::time_point time_point;
+	typedef typename Clock::duration duration;
+	typedef std::function<void()> task_type;
+
+	static constexpr std::size_t levels = 4;
+	static constexpr std::size_t slot_bits = 6;
+	static constexpr std::size_t slots = std::size_t(1) << slot_bits;
+
+	explicit timer_wheel_type(duration resolution = std::chrono::milliseconds(1),
+		time_point start = Clock::now())
+		: resolution(resolution), origin(start), current(0), pending(0), running(false)
+		, wakeup(idle) {}
+
+	timer_wheel_type(const timer_wheel_type &) = delete;
+
+	~timer_wheel_type() {
+		stop();
+	}
+
+	// The time of the last tick the wheel advanced to, or passed by Clock::now() if started.
+	time_point now() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		uint64_t tick(current);
+		if (running) {
+			auto ticks((Clock::now() - origin) / resolution);
+			if (ticks > 0 && uint64_t(ticks) > tick) {
+				tick = uint64_t(ticks);
+			}
+		}
+		return origin + resolution * tick;
+	}
+
+	// Runs task from within advance() once deadline has passed, rounded up to the next tick.
+	void schedule(time_point deadline, task_type &&task) {
+		std::unique_lock<std::mutex> lock(mutex);
+		// The idle thread leaves current behind, catch up so advance() need not walk the gap.
+		if (running && !pending) {
+			auto now((Clock::now() - origin) / resolution);
+			if (now > 0 && uint64_t(now) > current) {
+				current = uint64_t(now);
+			}
+		}
+		auto ticks((deadline - origin + resolution - duration(1)) / resolution);
+		uint64_t tick(ticks > 0 && uint64_t(ticks) > current ? uint64_t(ticks) : current + 1);
+		insert({ tick, std::move(task) });
+		++pending;
+		// Only wake the thread if it sleeps past the new timer.
+		if (tick < wakeup) {
+			wakeup = tick;
+			lock.unlock();
+			condition.notify_all();
+		}
+	}
+
+	// Expires every timer due at or before now, on the calling thread.
+	void advance(time_point now) {
+		std::vector<task_type> due;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto ticks((now - origin) / resolution);
+			uint64_t target(ticks > 0 ? uint64_t(ticks) : 0);
+			while (current < target) {
+				if (!pending) {
+					current = target;
+					break;
+				}
+				++current;
+				cascade();
+				auto &slot(wheel[0][current & (slots - 1)]);
+				for (auto &entry : slot) {
+					due.push_back(std::move(entry.task));
+				}
+				pending -= slot.size();
+				slot.clear();
+			}
+		}
+		for (auto &task : due) {
+			task();
+		}
+	}
+
+	// Advances with Clock::now() on a thread of its own until stopped. The thread sleeps until
+	// the next tick with timers to expire or cascade, indefinitely while none are pending.
+	void start() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (running) {
+			return;
+		}
+		running = true;
+		thread = std::thread([this]() {
+			std::unique_lock<std::mutex> lock(mutex);
+			while (running) {
+				wakeup = pending ? next_tick() : idle;
+				if (wakeup == idle) {
+					condition.wait(lock);
+				} else {
+					condition.wait_until(lock, origin + resolution * wakeup);
+				}
+				if (running) {
+					lock.unlock();
+					advance(Clock::now());
+					lock.lock();
+				}
+			}
+		});
+	}
+
+	void stop() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!running) {
+				return;
+			}
+			running = false;
+		}
+		condition.notify_all();
+		thread.join();
+	}
+
+	std::size_t size() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return pending;
+	}
+
+private:
+	struct entry_type {
+		uint64_t tick;
+		task_type task;
+	};
+
+	void insert(entry_type &&entry) {
+		auto delta(entry.tick - current);
+		std::size_t level(0);
+		while (level + 1 < levels && delta >= (uint64_t(1) << (slot_bits * (level + 1)))) {
+			++level;
+		}
+		wheel[level][(entry.tick >> (slot_bits * level)) & (slots - 1)].push_back(
+			std::move(entry));
+	}
+
+	// The first tick after the current one at which any slot holding timers is expired or
+	// cascaded, slots of level l are only visited at multiples of 64^l ticks.
+	uint64_t next_tick() const {
+		uint64_t next(idle);
+		for (std::size_t level = 0; level < levels; ++level) {
+			uint64_t block(uint64_t(1) << (slot_bits * level));
+			uint64_t tick((current / block + 1) * block);
+			for (std::size_t i = 0; i < slots && tick < next; ++i, tick += block) {
+				if (!wheel[level][(tick >> (slot_bits * level)) & (slots - 1)].empty()) {
+					next = tick;
+					break;
+				}
+			}
+		}
+		return next;
+	}
+
+	// Moves the timers of the slots starting at the current tick down a level.
+	void cascade() {
+		for (std::size_t level = 1; level < levels
+				&& !(current & ((uint64_t(1) << (slot_bits * level)) - 1)); ++level) {
+			std::vector<entry_type> entries;
+			entries.swap(wheel[level][(current >> (slot_bits * level)) & (slots - 1)]);
+			for (auto &entry : entries) {
+				insert(std::move(entry));
+			}
+		}
+	}
+
+	static constexpr uint64_t idle = ~uint64_t(0);
+
+	const duration resolution;
+	const time_point origin;
+	uint64_t current;
+	std::size_t pending;
+	std::array<std::array<std::vector<entry_type>, slots>, levels> wheel;
+	bool running;
+	uint64_t wakeup; // The tick the thread sleeps until.
+	std::thread thread;
+	std::condition_variable condition;
+	mutable std::mutex mutex;
+};
+
+// Shared by the operators unless given a wheel of their own, started on first use.
+inline timer_wheel_type<> &default_timer_wheel() {
+	static timer_wheel_type<> wheel;
+	static bool started((wheel.start(), true));
+	(void) started;
+	return wheel;
+}
+
+} // namespace frp
+
+#endif // _FRP_TIMER_WHEEL_H_
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_TRACE_H_
+#define _FRP_TRACE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace frp {
+namespace trace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// Complete events ('X') span a task, instant events ('i') mark a write or commit. Events of one
+// evaluation share node and evaluation, commits also carry the revision they produced.
+struct event_type {
+	const char *name;
+	char phase;
+	uint64_t thread;
+	clock_type::time_point timestamp;
+	clock_type::duration duration;
+	uint64_t node;
+	uint64_t evaluation;
+	uint64_t revision;
+};
+
+namespace details {
+
+struct chunk_type {
+	static constexpr std::size_t capacity = 1024;
+
+	chunk_type() : size(0), next(nullptr) {}
+
+	~chunk_type() {
+		delete next.load();
+	}
+
+	std::array<event_type, capacity> events;
+	std::atomic_size_t size;
+	std::atomic<chunk_type *> next;
+};
+
+// Written only by its own thread, read by write() once tracing has stopped. Chunks are reused
+// when a new session starts rather than freed.
+struct buffer_type {
+	explicit buffer_type(uint64_t thread) : thread(thread), session(0), tail(&head) {}
+
+	void append(uint64_t session, const event_type &event) {
+		if (this->session.load(std::memory_order_relaxed) != session) {
+			this->session.store(session, std::memory_order_relaxed);
+			for (auto chunk = &head; chunk; chunk = chunk->next.load(std::memory_order_relaxed)) {
+				chunk->size.store(0, std::memory_order_relaxed);
+			}
+			tail = &head;
+		}
+		auto size(tail->size.load(std::memory_order_relaxed));
+		if (size == chunk_type::capacity) {
+			auto next(tail->next.load(std::memory_order_relaxed));
+			if (!next) {
+				next = new chunk_type;
+				tail->next.store(next, std::memory_order_release);
+			}
+			tail = next;
+			size = 0;
+		}
+		tail->events[size] = event;
+		tail->events[size].thread = thread;
+		tail->size.store(size + 1, std::memory_order_release);
+	}
+
+	template<typename F>
+	void for_each(uint64_t session, F &&f) const {
+		if (this->session.load(std::memory_order_relaxed) != session) {
+			return;
+		}
+		for (auto chunk = &head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+			auto size(chunk->size.load(std::memory_order_acquire));
+			for (std::size_t i = 0; i < size; ++i) {
+				f(chunk->events[i]);
+			}
+		}
+	}
+
+	const uint64_t thread;
+
+private:
+	std::atomic<uint64_t> session;
+	chunk_type head;
+	chunk_type *tail;
+};
+
+struct tracer_type {
+	tracer_type() : session(0), active(false), threads(0) {}
+
+	static tracer_type &instance() {
+		static tracer_type tracer;
+		return tracer;
+	}
+
+	// Registers the buffer of the calling thread on first use, only this takes the lock.
+	buffer_type &buffer() {
+		thread_local std::shared_ptr<buffer_type> buffer([this]() {
+			auto buffer(std::make_shared<buffer_type>(++threads));
+			std::lock_guard<std::mutex> lock(mutex);
+			buffers.push_back(buffer);
+			return buffer;
+		}());
+		return *buffer;
+	}
+
+	void record(const event_type &event) {
+		buffer().append(session.load(std::memory_order_relaxed), event);
+	}
+
+	// Buffers of threads that have exited can no longer be written, drop them.
+	void start() {
+		std::lock_guard<std::mutex> lock(mutex);
+		buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const auto &buffer) {
+			return buffer.use_count() == 1;
+		}), buffers.end());
+		session.fetch_add(1, std::memory_order_relaxed);
+		active.store(true, std::memory_order_release);
+	}
+
+	template<typename F>
+	void for_each(F &&f) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const auto &buffer : buffers) {
+			buffer->for_each(session.load(std::memory_order_relaxed), f);
+		}
+	}
+
+	std::atomic<uint64_t> session;
+	std::atomic_bool active;
+
+private:
+	std::atomic<uint64_t> threads;
+	std::mutex mutex;
+	std::vector<std::shared_ptr<buffer_type>> buffers;
+};
+
+// Chrome expects microseconds, keep the nanoseconds as decimals.
+inline void write_microseconds(std::ostream &stream, clock_type::duration duration) {
+	auto nanoseconds(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+	auto fill(stream.fill('0'));
+	stream << nanoseconds / 1000 << '.' << std::setw(3) << nanoseconds % 1000;
+	stream.fill(fill);
+}
+
+} // namespace details
+
+// Starts a new session, discarding the events of the previous one.
+inline void start() {
+	details::tracer_type::instance().start();
+}
+
+inline void stop() {
+	details::tracer_type::instance().active.store(false, std::memory_order_release);
+}
+
+inline bool active() {
+	return details::tracer_type::instance().active.load(std::memory_order_acquire);
+}
+
+inline void instant(const char *name, uint64_t node, uint64_t evaluation, uint64_t revision) {
+	if (active()) {
+		details::tracer_type::instance().record({ name, 'i', 0, clock_type::now(),
+			clock_type::duration::zero(), node, evaluation, revision });
+	}
+}
+
+// Records a complete event on the calling thread when destroyed.
+struct span_type {
+	span_type(const char *name, uint64_t node, uint64_t evaluation)
+		: name(name), node(node), evaluation(evaluation)
+		, start(active() ? clock_type::now() : clock_type::time_point()) {}
+
+	span_type(const span_type &) = delete;
+
+	~span_type() {
+		if (start != clock_type::time_point() && active()) {
+			details::tracer_type::instance().record({ name, 'X', 0, start,
+				clock_type::now() - start, node, evaluation, 0 });
+		}
+	}
+
+private:
+	const char *name;
+	uint64_t node;
+	uint64_t evaluation;
+	clock_type::time_point start;
+};
+
+// Chrome trace event JSON, which Perfetto and chrome://tracing open directly. Call after stop(),
+// events recorded concurrently may be partially written.
+inline std::ostream &write(std::ostream &stream) {
+	stream << "{\"traceEvents\":[";
+	bool first(true);
+	details::tracer_type::instance().for_each([&](const event_type &event) {
+		stream << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"cat\":\"frp\""
+			<< ",\"ph\":\"" << event.phase << "\",\"pid\":0,\"tid\":" << event.thread
+			<< ",\"ts\":";
+		details::write_microseconds(stream, event.timestamp.time_since_epoch());
+		if (event.phase == 'X') {
+			stream << ",\"dur\":";
+			details::write_microseconds(stream, event.duration);
+		} else {
+			stream << ",\"s\":\"t\"";
+		}
+		stream << ",\"args\":{\"node\":" << event.node << ",\"evaluation\":" << event.evaluation
+			<< ",\"revision\":" << event.revision << "}}";
+		first = false;
+	});
+	return stream << "],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+inline bool write(const std::string &path) {
+	std::ofstream stream(path);
+	return !write(stream).fail();
+}
+
+} // namespace trace
+} // namespace frp
+
+#endif // _FRP_TRACE_H_
@@ -16,8 +16,10 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <frp/util/list.h>
 #include <functional>
+#include <memory>
 
 namespace frp {
 
@@ -39,41 +41,74 @@ struct array_deleter_type {
 	}
 };
 
+// Destroys the elements of a fixed size collector that were constructed. Others may have
+// been skipped, or never reached at all if the evaluation was cancelled or a function threw.
+template<typename T, typename Container, typename Allocator>
+struct sparse_array_deleter_type {
+
+	Container &container;
+
+	void operator()(T* ptr) {
+		for (std::size_t index = 0; index < container.capacity; ++index) {
+			if (container.is_constructed(index)) {
+				std::allocator_traits<Allocator>::destroy(container.allocator, &ptr[index]);
+			}
+		}
+		container.allocator.deallocate(ptr, container.capacity);
+	}
+};
+
 template<typename T, typename Comparator = std::equal_to<T>,
 	typename Allocator = std::allocator<T>>
 struct fixed_size_collector_type {
 	template<typename U, typename Allocator_, typename Comparator_>
 	friend struct frp::vector_view_type;
 	template<typename U, typename Container_, typename Allocator_>
-	friend struct array_deleter_type;
+	friend struct sparse_array_deleter_type;
 
-	typedef array_deleter_type<T, fixed_size_collector_type<T, Comparator, Allocator>, Allocator>
-		deleter_type;
+	typedef sparse_array_deleter_type<T, fixed_size_collector_type<T, Comparator, Allocator>,
+		Allocator> deleter_type;
 
 	explicit fixed_size_collector_type(std::size_t size, Allocator &&allocator = Allocator(),
 		const Comparator &comparator = Comparator())
 		: storage(allocator.allocate(size), deleter_type{ *this })
 		, storage_size(0)
 		, capacity(size)
+		, counter(0)
+		, constructed(new std::atomic<std::uint64_t>[(size + 63) / 64]())
 		, comparator(comparator) {}
 
 	fixed_size_collector_type(fixed_size_collector_type &&) = delete;
 
+	~fixed_size_collector_type() {
+		storage.reset();
+	}
+
 	template<typename... Args>
 	bool construct(std::size_t index, Args&&... args) {
 		assert(index < capacity);
-		auto size(++storage_size);
-		assert(storage_size <= capacity);
-
 		std::allocator_traits<Allocator>::construct(allocator, &storage[index],
 			std::forward<Args>(args)...);
-		return size == capacity;
+		constructed[index / 64] |= std::uint64_t(1) << (index % 64);
+		++storage_size;
+		assert(storage_size <= capacity);
+		return ++counter == capacity;
+	}
+
+	// Leaves index unconstructed, the collector can then no longer become a vector_view.
+	bool skip(std::size_t index) {
+		assert(index < capacity);
+		return ++counter == capacity;
 	}
 
 	std::size_t size() const {
 		return storage_size;
 	}
 
+	bool full() const {
+		return storage_size == capacity;
+	}
+
 private:
 	typedef std::unique_ptr<T[], deleter_type> storage_type;
 	storage_type storage;
@@ -81,6 +116,12 @@ private:
 	Allocator allocator;
 	std::atomic_size_t storage_size;
 	std::size_t capacity;
+	std::atomic_size_t counter;
+	std::unique_ptr<std::atomic<std::uint64_t>[]> constructed;
+
+	bool is_constructed(std::size_t index) const {
+		return constructed[index / 64] & (std::uint64_t(1) << (index % 64));
+	}
 };
 
 template<typename T, typename Comparator = std::equal_to<T>,
@@ -13,6 +13,7 @@
 #ifndef _FRP_UTIL_OBSERVABLE_H_
 #define _FRP_UTIL_OBSERVABLE_H_
 
+#include <atomic>
 #include <frp/util/list.h>
 #include <functional>
 #include <memory>
@@ -24,6 +25,7 @@ struct observable_type {
 
 	typedef std::function<void()> callback_type;
 	typedef single_list_type<callback_type> callback_container_type;
+	typedef std::function<void(const observable_type &)> demand_callback_type;
 
 	struct reference_type {
 
@@ -36,16 +38,36 @@ struct observable_type {
 
 			~storage_type() {
 				observable.callbacks.erase(std::move(iterator));
+				if (observable.observers.fetch_sub(1) == 1) {
+					observable.demand();
+				}
 			}
 		};
 
 		std::unique_ptr<storage_type> storage;
 	};
 
+	observable_type() : observers(0) {}
+
 	template<typename F>
 	reference_type add_callback(F &&f) {
-		return { std::make_unique<reference_type::storage_type>(
+		reference_type reference{ std::make_unique<reference_type::storage_type>(
 			callbacks.insert(std::forward<F>(f)), *this) };
+		if (observers.fetch_add(1) == 0) {
+			demand();
+		}
+		return reference;
+	}
+
+	// Invoked whenever the number of observers changes between zero and non-zero. The
+	// transitions may race, so the callback must read observed() instead of assuming either.
+	template<typename F>
+	void set_demand_callback(F &&f) {
+		demand_callback = std::forward<F>(f);
+	}
+
+	bool observed() const {
+		return observers.load() > 0;
 	}
 
 	void update() const {
@@ -55,7 +77,15 @@ struct observable_type {
 	}
 
 private:
+	void demand() const {
+		if (demand_callback) {
+			demand_callback(*this);
+		}
+	}
+
 	callback_container_type callbacks;
+	std::atomic_size_t observers;
+	demand_callback_type demand_callback;
 };
 
 template<typename O, typename F>
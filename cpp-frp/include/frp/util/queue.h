@@ -0,0 +1,150 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_UTIL_QUEUE_H_
+#define _FRP_UTIL_QUEUE_H_
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace frp {
+namespace util {
+
+// Bounded lock-free queue supporting multiple producers and multiple consumers.
+// Every cell carries a sequence number which tells producers and consumers whether the
+// cell is ready to be written or read for the current lap around the ring.
+template<typename T>
+struct bounded_queue_type {
+
+	explicit bounded_queue_type(std::size_t size)
+		: mask(round_up(size) - 1)
+		, cells(new cell_type[mask + 1])
+		, enqueue_position(0)
+		, dequeue_position(0) {
+		for (std::size_t index = 0; index <= mask; ++index) {
+			cells[index].sequence.store(index, std::memory_order_relaxed);
+		}
+	}
+
+	bounded_queue_type(bounded_queue_type &&) = delete;
+
+	~bounded_queue_type() {
+		consume([](T &&) {});
+	}
+
+	bool push(T &&value) {
+		return emplace(std::forward<T>(value));
+	}
+
+	bool push(const T &value) {
+		return emplace(value);
+	}
+
+	template<typename F>
+	bool pop(F &&f) {
+		std::size_t position(dequeue_position.load(std::memory_order_relaxed));
+		for (;;) {
+			auto &cell(cells[position & mask]);
+			std::size_t sequence(cell.sequence.load(std::memory_order_acquire));
+			auto difference(std::ptrdiff_t(sequence) - std::ptrdiff_t(position + 1));
+			if (difference == 0) {
+				if (dequeue_position.compare_exchange_weak(position, position + 1,
+						std::memory_order_relaxed)) {
+					auto &value(*reinterpret_cast<T *>(&cell.storage));
+					f(std::move(value));
+					value.~T();
+					cell.sequence.store(position + mask + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0) {
+				return false;
+			} else {
+				position = dequeue_position.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	template<typename F>
+	std::size_t consume(F &&f) {
+		std::size_t count(0);
+		while (pop(f)) {
+			++count;
+		}
+		return count;
+	}
+
+	// Approximate number of elements, exact only when there are no concurrent operations.
+	std::size_t size() const {
+		auto enqueued(enqueue_position.load(std::memory_order_relaxed));
+		auto dequeued(dequeue_position.load(std::memory_order_relaxed));
+		return enqueued > dequeued ? enqueued - dequeued : 0;
+	}
+
+	std::size_t capacity() const {
+		return mask + 1;
+	}
+
+private:
+	static std::size_t round_up(std::size_t size) {
+		std::size_t capacity(2);
+		while (capacity < size) {
+			capacity <<= 1;
+		}
+		return capacity;
+	}
+
+	template<typename U>
+	bool emplace(U &&value) {
+		std::size_t position(enqueue_position.load(std::memory_order_relaxed));
+		for (;;) {
+			auto &cell(cells[position & mask]);
+			std::size_t sequence(cell.sequence.load(std::memory_order_acquire));
+			auto difference(std::ptrdiff_t(sequence) - std::ptrdiff_t(position));
+			if (difference == 0) {
+				if (enqueue_position.compare_exchange_weak(position, position + 1,
+						std::memory_order_relaxed)) {
+					new (&cell.storage) T(std::forward<U>(value));
+					cell.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0) {
+				return false;
+			} else {
+				position = enqueue_position.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	struct cell_type {
+		std::atomic_size_t sequence;
+		std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+	};
+
+	// Keep the producer and consumer positions on separate cache lines.
+	typedef char padding_type[64];
+
+	const std::size_t mask;
+	std::unique_ptr<cell_type[]> cells;
+	padding_type padding0;
+	std::atomic_size_t enqueue_position;
+	padding_type padding1;
+	std::atomic_size_t dequeue_position;
+	padding_type padding2;
+};
+
+} // namespace util
+} // namespace frp
+
+#endif // _FRP_UTIL_QUEUE_H_
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_UTIL_WINDOW_H_
+#define _FRP_UTIL_WINDOW_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace frp {
+namespace util {
+
+// First in, first out queue stored in a power of two sized vector which only grows.
+template<typename T>
+struct ring_buffer_type {
+	bool empty() const {
+		return count == 0;
+	}
+
+	std::size_t size() const {
+		return count;
+	}
+
+	const T &front() const {
+		return buffer[head];
+	}
+
+	void push_back(T &&value) {
+		if (count == buffer.size()) {
+			grow();
+		}
+		buffer[(head + count++) & (buffer.size() - 1)] = std::move(value);
+	}
+
+	T pop_front() {
+		T value(std::move(buffer[head]));
+		head = (head + 1) & (buffer.size() - 1);
+		--count;
+		return value;
+	}
+
+private:
+	void grow() {
+		std::vector<T> grown(std::max<std::size_t>(buffer.size() * 2, 8));
+		for (std::size_t i = 0; i < count; ++i) {
+			grown[i] = std::move(buffer[(head + i) & (buffer.size() - 1)]);
+		}
+		buffer.swap(grown);
+		head = 0;
+	}
+
+	std::vector<T> buffer;
+	std::size_t head = 0;
+	std::size_t count = 0;
+};
+
+// Aggregate of a queue of values, for aggregates with an inverse. Evicted values are
+// subtracted from the running aggregate.
+template<typename T, typename Aggregate>
+struct subtracting_window_type {
+	explicit subtracting_window_type(const Aggregate &aggregate) : aggregate(aggregate) {}
+
+	bool empty() const {
+		return values.empty();
+	}
+
+	std::size_t size() const {
+		return values.size();
+	}
+
+	void push(T &&value) {
+		current = values.empty() ? value : aggregate.combine(current, value);
+		values.push_back(std::move(value));
+	}
+
+	void pop() {
+		auto value(values.pop_front());
+		if (!values.empty()) {
+			current = aggregate.inverse(current, value);
+		}
+	}
+
+	const T &get() const {
+		return current;
+	}
+
+private:
+	Aggregate aggregate;
+	ring_buffer_type<T> values;
+	T current;
+};
+
+// Aggregate of a queue of values, for any associative aggregate. Values are pushed on the
+// back stack, which keeps a running aggregate. Once the front stack is empty, the back
+// stack is moved onto it, each entry holding the aggregate of itself and all newer entries.
+// Both push and pop are amortized O(1) without ever inverting the aggregate.
+template<typename T, typename Aggregate>
+struct two_stack_window_type {
+	explicit two_stack_window_type(const Aggregate &aggregate) : aggregate(aggregate) {}
+
+	bool empty() const {
+		return front.empty() && back.empty();
+	}
+
+	std::size_t size() const {
+		return front.size() + back.size();
+	}
+
+	void push(T &&value) {
+		back_aggregate = back.empty() ? value : aggregate.combine(back_aggregate, value);
+		back.push_back(std::move(value));
+	}
+
+	void pop() {
+		if (front.empty()) {
+			while (!back.empty()) {
+				front.push_back(front.empty() ? std::move(back.back())
+					: aggregate.combine(back.back(), front.back()));
+				back.pop_back();
+			}
+		}
+		front.pop_back();
+	}
+
+	T get() const {
+		return front.empty() ? back_aggregate : back.empty() ? front.back()
+			: aggregate.combine(front.back(), back_aggregate);
+	}
+
+private:
+	Aggregate aggregate;
+	std::vector<T> front;
+	std::vector<T> back;
+	T back_aggregate;
+};
+
+} // namespace util
+} // namespace frp
+
+#endif // _FRP_UTIL_WINDOW_H_
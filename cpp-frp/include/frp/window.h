@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRP_WINDOW_H_
+#define _FRP_WINDOW_H_
+
+#include <frp/util/window.h>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace frp {
+namespace window {
+
+// lift maps an element to a value, combine must be associative and inverse, if given,
+// must undo combine such that inverse(combine(a, b), a) == b.
+template<typename Lift, typename Combine, typename Inverse = void>
+struct aggregate_type {
+	template<typename T>
+	auto lift(const T &value) const {
+		return lift_function(value);
+	}
+
+	template<typename T>
+	auto combine(const T &a, const T &b) const {
+		return combine_function(a, b);
+	}
+
+	template<typename T>
+	auto inverse(const T &a, const T &b) const {
+		return inverse_function(a, b);
+	}
+
+	Lift lift_function;
+	Combine combine_function;
+	Inverse inverse_function;
+};
+
+template<typename Lift, typename Combine>
+struct aggregate_type<Lift, Combine, void> {
+	template<typename T>
+	auto lift(const T &value) const {
+		return lift_function(value);
+	}
+
+	template<typename T>
+	auto combine(const T &a, const T &b) const {
+		return combine_function(a, b);
+	}
+
+	Lift lift_function;
+	Combine combine_function;
+};
+
+template<typename Lift, typename Combine>
+auto aggregate(Lift lift, Combine combine) {
+	return aggregate_type<Lift, Combine>{ std::move(lift), std::move(combine) };
+}
+
+template<typename Lift, typename Combine, typename Inverse>
+auto aggregate(Lift lift, Combine combine, Inverse inverse) {
+	return aggregate_type<Lift, Combine, Inverse>{ std::move(lift), std::move(combine),
+		std::move(inverse) };
+}
+
+template<typename Lift>
+auto sum(Lift lift) {
+	return window::aggregate(std::move(lift), std::plus<>(), std::minus<>());
+}
+
+} // namespace window
+
+namespace util {
+
+template<typename Aggregate, typename T>
+using window_value_t = std::decay_t<decltype(
+	std::declval<const Aggregate &>().lift(std::declval<const T &>()))>;
+
+template<typename Aggregate>
+struct is_invertible_aggregate : std::false_type {};
+
+template<typename Lift, typename Combine, typename Inverse>
+struct is_invertible_aggregate<window::aggregate_type<Lift, Combine, Inverse>>
+	: std::integral_constant<bool, !std::is_void<Inverse>::value> {};
+
+// Subtracts on eviction when the aggregate has an inverse, falls back to two stacks.
+template<typename Aggregate, typename T>
+using window_t = std::conditional_t<is_invertible_aggregate<Aggregate>::value,
+	subtracting_window_type<T, Aggregate>, two_stack_window_type<T, Aggregate>>;
+
+} // namespace util
+} // namespace frp
+
+#endif // _FRP_WINDOW_H_
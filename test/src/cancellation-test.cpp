@@ -0,0 +1,163 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <frp/cancellation.h>
+#include <frp/static/push/filter.h>
+#include <frp/static/push/group_by.h>
+#include <frp/static/push/map.h>
+#include <frp/static/push/map_cache.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/sort.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/transform.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <task_queue.h>
+#include <vector>
+
+TEST(cancellation, token) {
+	auto generation(std::make_shared<frp::util::generation_type>(0));
+	auto first(frp::util::next_cancellation(generation));
+	ASSERT_FALSE(first.cancelled());
+	auto second(frp::util::next_cancellation(generation));
+	ASSERT_TRUE(first.cancelled());
+	ASSERT_FALSE(second.cancelled());
+	ASSERT_FALSE(frp::util::cancellation_type().cancelled());
+	ASSERT_FALSE(frp::cancelled());
+	{
+		frp::util::cancellation_scope_type scope(first);
+		ASSERT_TRUE(frp::cancelled());
+	}
+	ASSERT_FALSE(frp::cancelled());
+}
+
+TEST(cancellation, transform) {
+	task_queue queue;
+	auto source(fsp::source(1));
+	int evaluations(0);
+	auto doubled(fsp::transform(frp::execute_on(std::ref(queue), [&](int i) {
+		++evaluations;
+		return i * 2;
+	}), std::ref(source)));
+	auto sink(fsp::sink(std::ref(doubled)));
+	source = 2;
+	source = 3;
+	queue.process_all();
+	ASSERT_EQ(evaluations, 1);
+	ASSERT_EQ(**sink, 6);
+}
+
+TEST(cancellation, map) {
+	task_queue queue;
+	auto source(fsp::source(std::vector<std::string>{ "a", "b", "c" }));
+	int evaluations(0);
+	auto mapped(fsp::map(frp::execute_on(std::ref(queue), [&](const std::string &value) {
+		++evaluations;
+		return value + value;
+	}), std::ref(source)));
+	auto sink(fsp::sink(std::ref(mapped)));
+	queue.process_one();
+	source = std::vector<std::string>{ "d", "e" };
+	queue.process_all();
+	ASSERT_EQ(evaluations, 3);
+	auto reference(*sink);
+	ASSERT_EQ(std::vector<std::string>(reference->begin(), reference->end()),
+		std::vector<std::string>({ "dd", "ee" }));
+}
+
+TEST(cancellation, map_cache) {
+	task_queue queue;
+	auto source(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	int evaluations(0);
+	auto mapped(fsp::map_cache(frp::execute_on(std::ref(queue), [&](int value) {
+		++evaluations;
+		return value * 2;
+	}), std::ref(source)));
+	auto sink(fsp::sink(std::ref(mapped)));
+	source = std::vector<int>{ 4 };
+	queue.process_all();
+	ASSERT_EQ(evaluations, 1);
+	auto reference(*sink);
+	ASSERT_EQ(std::vector<int>(reference->begin(), reference->end()), std::vector<int>({ 8 }));
+}
+
+TEST(cancellation, filter) {
+	task_queue queue;
+	auto source(fsp::source(std::vector<int>{ 1, 2, 3, 4 }));
+	int evaluations(0);
+	auto filtered(fsp::filter(frp::execute_on(std::ref(queue), [&](int value) {
+		++evaluations;
+		return value % 2 == 0;
+	}), std::ref(source)));
+	auto sink(fsp::sink(std::ref(filtered)));
+	queue.process_one();
+	source = std::vector<int>{ 5, 6 };
+	queue.process_all();
+	ASSERT_EQ(evaluations, 3);
+	auto reference(*sink);
+	ASSERT_EQ(std::vector<int>(reference->begin(), reference->end()), std::vector<int>({ 6 }));
+}
+
+TEST(cancellation, sort) {
+	task_queue queue;
+	std::vector<std::string> values;
+	for (int i = 0; i < 10000; ++i) {
+		values.push_back(std::to_string(i * 7919 % 10000));
+	}
+	auto source(fsp::source(std::vector<std::string>(values)));
+	auto sorted(fsp::sink(fsp::sort(frp::execute_on(std::ref(queue),
+		std::less<std::string>()), std::ref(source))));
+	queue.process_one();
+	values.resize(5000);
+	source = std::vector<std::string>(values);
+	while (!queue.empty()) {
+		queue.process_all();
+	}
+	std::sort(values.begin(), values.end());
+	auto reference(*sorted);
+	ASSERT_EQ(std::vector<std::string>(reference->begin(), reference->end()), values);
+}
+
+TEST(cancellation, group_by) {
+	task_queue queue;
+	auto source(fsp::source(std::vector<std::string>{ "apple", "banana", "avocado" }));
+	auto grouped(fsp::sink(fsp::group_by(frp::execute_on(std::ref(queue),
+		[](const std::string &value) { return value[0]; }), std::ref(source))));
+	source = std::vector<std::string>{ "cherry", "blueberry", "cranberry" };
+	while (!queue.empty()) {
+		queue.process_all();
+	}
+	auto reference(*grouped);
+	ASSERT_EQ(reference->size(), 2u);
+	ASSERT_EQ((*reference)[0].key(), 'c');
+	ASSERT_EQ(std::vector<std::string>((*reference)[0].begin(), (*reference)[0].end()),
+		std::vector<std::string>({ "cherry", "cranberry" }));
+}
+
+TEST(cancellation, query) {
+	task_queue queue;
+	auto source(fsp::source(1));
+	std::vector<bool> cancelled;
+	auto sink(fsp::sink(fsp::transform(frp::execute_on(std::ref(queue), [&](int i) {
+		if (i == 1) {
+			source = 2;
+		}
+		cancelled.push_back(frp::cancelled());
+		return i;
+	}), std::ref(source))));
+	queue.process_all();
+	queue.process_all();
+	ASSERT_EQ(cancelled, std::vector<bool>({ true, false }));
+	ASSERT_EQ(**sink, 2);
+}
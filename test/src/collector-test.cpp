@@ -14,6 +14,7 @@
 #include <frp/util/collector.h>
 #include <frp/vector_view.h>
 #include <gtest/gtest.h>
+#include <memory>
 
 struct movable_type {
 	movable_type(int value = 0) : value(value) {}
@@ -57,6 +58,18 @@ TEST(fixed_size_collector, test1) {
 		movables.rend()));
 }
 
+TEST(fixed_size_collector, destroys_constructed) {
+	auto counter(std::make_shared<int>(0));
+	{
+		frp::util::fixed_size_collector_type<std::shared_ptr<int>> collector(130);
+		collector.construct(3, counter);
+		collector.skip(64);
+		collector.construct(129, counter);
+		ASSERT_EQ(counter.use_count(), 3);
+	}
+	ASSERT_EQ(counter.use_count(), 1);
+}
+
 TEST(vector_view, empty_collector) {
 	frp::vector_view_type<movable_type> vector_view(
 		frp::util::fixed_size_collector_type<movable_type>(0));
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/static/push/map.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/subscribe.h>
+#include <frp/static/push/transform.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(demand, suspend_without_sinks) {
+	auto source(fsp::source(1));
+	int evaluations(0);
+	auto doubled(fsp::transform([&](int i) { ++evaluations; return i * 2; }, std::ref(source)));
+	ASSERT_EQ(evaluations, 1);
+	{
+		auto sink(fsp::sink(std::ref(doubled)));
+		source = 2;
+		ASSERT_EQ(**sink, 4);
+		ASSERT_EQ(evaluations, 2);
+	}
+	source = 3;
+	source = 4;
+	ASSERT_EQ(evaluations, 2);
+	auto sink(fsp::sink(std::ref(doubled)));
+	ASSERT_EQ(**sink, 8);
+	ASSERT_EQ(evaluations, 3);
+}
+
+TEST(demand, resume_without_changes) {
+	auto source(fsp::source(1));
+	int evaluations(0);
+	auto doubled(fsp::transform([&](int i) { ++evaluations; return i * 2; }, std::ref(source)));
+	{
+		auto sink(fsp::sink(std::ref(doubled)));
+	}
+	auto sink(fsp::sink(std::ref(doubled)));
+	ASSERT_EQ(**sink, 2);
+	ASSERT_EQ(evaluations, 1);
+}
+
+TEST(demand, transitive) {
+	auto source(fsp::source(std::vector<int>{ 1, 2 }));
+	int evaluations(0);
+	auto squared(fsp::map([&](int i) { ++evaluations; return i * i; }, std::ref(source)));
+	auto sum(fsp::transform([](const auto &values) {
+		int sum(0);
+		for (auto value : values) {
+			sum += value;
+		}
+		return sum;
+	}, std::ref(squared)));
+	{
+		auto sink(fsp::sink(std::ref(sum)));
+		ASSERT_EQ(**sink, 5);
+	}
+	ASSERT_EQ(evaluations, 2);
+	source = std::vector<int>{ 1, 2, 3 };
+	ASSERT_EQ(evaluations, 2);
+	auto sink(fsp::sink(std::ref(sum)));
+	ASSERT_EQ(**sink, 14);
+	ASSERT_EQ(evaluations, 5);
+}
+
+TEST(demand, subscription) {
+	auto source(fsp::source(1));
+	int evaluations(0);
+	auto doubled(fsp::transform([&](int i) { ++evaluations; return i * 2; }, std::ref(source)));
+	int last(0);
+	{
+		auto subscription(fsp::subscribe([&](int i) { last = i; }, std::ref(doubled)));
+		source = 2;
+		ASSERT_EQ(last, 4);
+	}
+	source = 3;
+	ASSERT_EQ(evaluations, 2);
+	ASSERT_EQ(last, 4);
+}
+
+TEST(demand, eager_without_observers) {
+	auto source(fsp::source(1));
+	int evaluations(0);
+	auto effect(fsp::transform([&](int) { ++evaluations; }, std::ref(source)));
+	source = 2;
+	source = 3;
+	ASSERT_EQ(evaluations, 3);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/execute_on.h>
+#include <frp/priority_thread_pool.h>
+#include <frp/static/push/group_by.h>
+#include <frp/static/push/map.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+#include <vector>
+
+TEST(group_by, keys) {
+	auto words(fsp::source(std::vector<std::string>{ "banana", "apple", "blueberry", "cherry",
+		"avocado" }));
+	auto grouped(fsp::sink(fsp::group_by([](const std::string &word) { return word[0]; },
+		std::ref(words))));
+	auto reference(*grouped);
+	ASSERT_EQ(reference->size(), 3u);
+	ASSERT_EQ((*reference)[0].key(), 'b');
+	ASSERT_EQ(std::vector<std::string>((*reference)[0].begin(), (*reference)[0].end()),
+		std::vector<std::string>({ "banana", "blueberry" }));
+	ASSERT_EQ((*reference)[1].key(), 'a');
+	ASSERT_EQ((*reference)[2].size(), 1u);
+	ASSERT_EQ(reference->find('c')->key(), 'c');
+	ASSERT_EQ(reference->find('d'), reference->end());
+	ASSERT_EQ(reference->values().size(), 5u);
+}
+
+TEST(group_by, dependencies) {
+	auto modulo(fsp::source(3));
+	auto values(fsp::source(std::vector<int>{ 1, 2, 3, 4, 5, 6 }));
+	auto grouped(fsp::sink(fsp::group_by<1>([](int modulo, int value) {
+		return value % modulo;
+	}, std::ref(modulo), std::ref(values))));
+	ASSERT_EQ((*grouped)->size(), 3u);
+	modulo = 2;
+	ASSERT_EQ((*grouped)->size(), 2u);
+	values = std::vector<int>{};
+	ASSERT_TRUE((*grouped)->empty());
+}
+
+TEST(group_by, compares_values) {
+	auto values(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto grouped(fsp::sink(fsp::group_by([](int value) { return value % 2; },
+		std::ref(values))));
+	auto before(*grouped);
+	values = std::vector<int>{ 1, 2, 5 };
+	auto after(*grouped);
+	ASSERT_EQ((*before)[0].key(), (*after)[0].key());
+	ASSERT_EQ((*before)[0].size(), (*after)[0].size());
+	ASSERT_FALSE((*before)[0] == (*after)[0]);
+	ASSERT_TRUE((*before)[1] == (*after)[1]);
+}
+
+TEST(group_by, parallel_map_per_group) {
+	frp::priority_thread_pool_type pool(4, 1);
+	std::vector<int> input(50000);
+	std::iota(input.begin(), input.end(), 0);
+	auto values(fsp::source(std::vector<int>(input)));
+	auto grouped(fsp::group_by(frp::execute_on(pool.priority(0), [](int value) {
+		return value % 7;
+	}), std::ref(values)));
+	auto sums(fsp::sink(fsp::map([](const auto &group) {
+		return std::accumulate(group.begin(), group.end(), 0LL);
+	}, std::ref(grouped))));
+	pool.wait_idle();
+	auto reference(*sums);
+	ASSERT_EQ(reference->size(), 7u);
+	for (int key = 0; key < 7; ++key) {
+		long long expected(0);
+		for (int value = key; value < 50000; value += 7) {
+			expected += value;
+		}
+		ASSERT_EQ((*reference)[key], expected);
+	}
+}
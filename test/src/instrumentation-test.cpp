@@ -0,0 +1,224 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/instrumentation.h>
+#include <frp/static/pull/sink.h>
+#include <frp/static/pull/transform.h>
+#include <frp/static/push/map.h>
+#include <frp/static/push/sample.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/transform.h>
+#include <frp/trace.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Compiled both with and without FRP_ENABLE_INSTRUMENTATION, see test/CMakeLists.txt.
+#ifdef FRP_ENABLE_INSTRUMENTATION
+
+namespace {
+
+// The statistics of the most recently created node.
+std::shared_ptr<const frp::instrumentation::node_statistics_type> last_node() {
+	auto nodes(frp::instrumentation::registry().snapshot());
+	return nodes.empty() ? nullptr : *std::max_element(nodes.begin(), nodes.end(),
+		[](const auto &lhs, const auto &rhs) { return lhs->id < rhs->id; });
+}
+
+} // namespace
+
+TEST(instrumentation, commits) {
+	ASSERT_TRUE(frp::instrumentation::enabled());
+	auto source(fsp::source(1));
+	auto parity(fsp::transform([](int i) { return i % 2; }, std::ref(source)));
+	auto statistics(last_node());
+	ASSERT_NE(statistics, nullptr);
+	ASSERT_EQ(statistics->evaluations, 1u);
+	ASSERT_EQ(statistics->commits, 1u);
+	source = 2;
+	ASSERT_EQ(statistics->evaluations, 2u);
+	ASSERT_EQ(statistics->commits, 2u);
+	ASSERT_EQ(statistics->suppressed, 0u);
+	source = 4;
+	ASSERT_EQ(statistics->evaluations, 3u);
+	ASSERT_EQ(statistics->commits, 2u);
+	ASSERT_EQ(statistics->suppressed, 1u);
+	ASSERT_EQ(statistics->rejected, 0u);
+	ASSERT_EQ(statistics->latency.total(), 3u);
+}
+
+TEST(instrumentation, rejected) {
+	auto source(fsp::source(1));
+	bool reentered(false);
+	// The first evaluation updates the source from within itself. Running tasks directly instead
+	// of on the trampoline lets the newer evaluation commit first, rejecting the older result.
+	auto doubled(fsp::transform(frp::execute_on([](auto &&task) { task(); }, [&](int i) {
+		if (!reentered) {
+			reentered = true;
+			source = 2;
+		}
+		return i * 2;
+	}), std::ref(source)));
+	auto statistics(last_node());
+	auto sink(fsp::sink(std::ref(doubled)));
+	ASSERT_EQ(**sink, 4);
+	ASSERT_EQ(statistics->evaluations, 2u);
+	ASSERT_EQ(statistics->commits, 1u);
+	ASSERT_EQ(statistics->rejected, 1u);
+}
+
+TEST(instrumentation, map) {
+	auto source(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto mapped(fsp::map([](int i) { return i * 2; }, std::ref(source)));
+	auto statistics(last_node());
+	source = std::vector<int>{ 4, 5 };
+	ASSERT_EQ(statistics->evaluations, 2u);
+	ASSERT_EQ(statistics->commits, 2u);
+	ASSERT_EQ(statistics->latency.total(), 2u);
+}
+
+TEST(instrumentation, sample) {
+	auto clock(fsp::source(0));
+	auto value(fsp::source(1));
+	auto sampled(fsp::sample(std::ref(clock), std::ref(value)));
+	auto statistics(last_node());
+	clock = 1;
+	clock = 2;
+	ASSERT_EQ(statistics->evaluations, 3u);
+	ASSERT_EQ(statistics->commits, 1u);
+	value = 2;
+	clock = 3;
+	ASSERT_EQ(statistics->commits, 2u);
+}
+
+TEST(instrumentation, registry) {
+	auto count(frp::instrumentation::registry().snapshot().size());
+	{
+		auto source(fsp::source(1));
+		auto first(fsp::transform([](int i) { return i; }, std::ref(source)));
+		auto second(fsp::transform([](int i) { return i; }, std::ref(first)));
+		ASSERT_EQ(frp::instrumentation::registry().snapshot().size(), count + 3);
+	}
+	ASSERT_EQ(frp::instrumentation::registry().snapshot().size(), count);
+}
+
+TEST(instrumentation, graph) {
+	auto source(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto source_node(last_node());
+	auto sum(fsp::transform([](const auto &values) {
+		return std::accumulate(values.begin(), values.end(), 0);
+	}, std::ref(source)));
+	auto sum_node(last_node());
+	auto lazy(fspl::transform([](int sum, const auto &values) {
+		return sum * int(values.size());
+	}, std::ref(sum), std::ref(source)));
+	auto lazy_node(last_node());
+
+	ASSERT_EQ(source_node->dependencies.size(), 0u);
+	ASSERT_EQ(sum_node->dependencies, std::vector<uint64_t>{ source_node->id });
+	ASSERT_EQ(lazy_node->dependencies,
+		(std::vector<uint64_t>{ sum_node->id, source_node->id }));
+	auto snapshot(frp::instrumentation::registry().snapshot());
+	ASSERT_EQ(frp::instrumentation::dependents(snapshot, source_node->id),
+		(std::vector<uint64_t>{ sum_node->id, lazy_node->id }));
+
+	ASSERT_EQ(source_node->revision, 0u);
+	ASSERT_EQ(source_node->size, sizeof(std::vector<int>) + 3 * sizeof(int));
+	ASSERT_EQ(sum_node->revision, 1u);
+	ASSERT_EQ(sum_node->size, sizeof(int));
+	source = std::vector<int>{ 4, 5 };
+	ASSERT_EQ(source_node->revision, 1u);
+	ASSERT_EQ(sum_node->revision, 2u);
+	ASSERT_EQ(lazy_node->evaluations, 0u);
+	auto lazy_sink(fspl::sink(std::ref(lazy)));
+	ASSERT_EQ(**lazy_sink, 18);
+	ASSERT_EQ(lazy_node->evaluations, 1u);
+
+	std::stringstream dot;
+	frp::instrumentation::write_dot(dot, snapshot);
+	ASSERT_EQ(dot.str().find("digraph frp {"), 0u);
+	ASSERT_NE(dot.str().find("n" + std::to_string(source_node->id) + " -> n"
+		+ std::to_string(sum_node->id) + ";"), std::string::npos);
+	std::stringstream json;
+	frp::instrumentation::write_json(json, snapshot);
+	ASSERT_NE(json.str().find("{\"id\":" + std::to_string(sum_node->id)), std::string::npos);
+	ASSERT_NE(json.str().find("\"dependencies\":[" + std::to_string(sum_node->id) + ","
+		+ std::to_string(source_node->id) + "]"), std::string::npos);
+}
+
+namespace {
+
+std::size_t occurrences(const std::string &text, const std::string &pattern) {
+	std::size_t count(0);
+	for (auto i = text.find(pattern); i != std::string::npos; i = text.find(pattern, i + 1)) {
+		++count;
+	}
+	return count;
+}
+
+} // namespace
+
+TEST(instrumentation, trace) {
+	auto source(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto source_node(last_node());
+	auto mapped(fsp::map([](int i) { return i * 2; }, std::ref(source)));
+	auto mapped_node(last_node());
+	auto sum(fsp::transform([](const auto &values) {
+		return std::accumulate(values.begin(), values.end(), 0);
+	}, std::ref(mapped)));
+
+	frp::trace::start();
+	ASSERT_TRUE(frp::trace::active());
+	source = std::vector<int>{ 4, 5 };
+	frp::trace::stop();
+	source = std::vector<int>{ 6 };
+
+	std::stringstream stream;
+	frp::trace::write(stream);
+	auto trace(stream.str());
+	ASSERT_EQ(trace.find("{\"traceEvents\":["), 0u);
+	ASSERT_EQ(occurrences(trace, "\"name\":\"write\""), 1u);
+	ASSERT_NE(trace.find("\"name\":\"write\",\"cat\":\"frp\",\"ph\":\"i\""),
+		std::string::npos);
+	ASSERT_NE(trace.find("\"node\":" + std::to_string(source_node->id) + ",\"evaluation\":1,"
+		"\"revision\":1}"), std::string::npos);
+	// Two element tasks of the map and one task of the transform.
+	ASSERT_EQ(occurrences(trace, "\"name\":\"evaluate\""), 3u);
+	ASSERT_EQ(occurrences(trace, "\"node\":" + std::to_string(mapped_node->id)
+		+ ",\"evaluation\":1,"), 3u);
+	ASSERT_EQ(occurrences(trace, "\"name\":\"commit\""), 2u);
+
+	// A new session discards the previous events.
+	frp::trace::start();
+	frp::trace::stop();
+	std::stringstream empty;
+	frp::trace::write(empty);
+	ASSERT_EQ(occurrences(empty.str(), "\"name\""), 0u);
+}
+
+#else
+
+TEST(instrumentation, disabled) {
+	ASSERT_FALSE(frp::instrumentation::enabled());
+	static_assert(std::is_empty<frp::util::instrumentation_type>::value,
+		"Disabled instrumentation must not add state to repositories.");
+	auto source(fsp::source(1));
+	auto doubled(fsp::transform([](int i) { return i * 2; }, std::ref(source)));
+	ASSERT_TRUE(frp::instrumentation::registry().snapshot().empty());
+}
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <frp/execute_on.h>
+#include <frp/priority_thread_pool.h>
+#include <frp/static/push/join.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct join_order_type {
+	int instrument;
+	int quantity;
+
+	bool operator==(const join_order_type &order) const {
+		return instrument == order.instrument && quantity == order.quantity;
+	}
+};
+
+struct join_instrument_type {
+	int id;
+	std::string symbol;
+
+	bool operator==(const join_instrument_type &instrument) const {
+		return id == instrument.id && symbol == instrument.symbol;
+	}
+};
+
+template<typename Reference>
+std::vector<std::string> to_vector(const Reference &reference) {
+	return std::vector<std::string>(reference->begin(), reference->end());
+}
+
+} // namespace
+
+TEST(join, inner) {
+	auto orders(fsp::source(std::vector<join_order_type>{ { 1, 10 }, { 3, 30 }, { 2, 20 },
+		{ 1, 11 } }));
+	auto instruments(fsp::source(std::vector<join_instrument_type>{ { 1, "GOOG" },
+		{ 2, "AAPL" } }));
+	auto joined(fsp::sink(fsp::join([](const join_order_type &order) { return order.instrument; },
+		[](const join_instrument_type &instrument) { return instrument.id; },
+		[](const join_order_type &order, const join_instrument_type &instrument) {
+			return instrument.symbol + ":" + std::to_string(order.quantity);
+		}, std::ref(orders), std::ref(instruments))));
+	ASSERT_EQ(to_vector(*joined), std::vector<std::string>({ "GOOG:10", "AAPL:20", "GOOG:11" }));
+
+	orders = std::vector<join_order_type>{ { 2, 5 } };
+	ASSERT_EQ(to_vector(*joined), std::vector<std::string>({ "AAPL:5" }));
+	instruments = std::vector<join_instrument_type>{};
+	ASSERT_TRUE((*joined)->empty());
+}
+
+TEST(join, reuses_table) {
+	std::atomic_int keyed(0);
+	auto orders(fsp::source(std::vector<join_order_type>{ { 1, 10 }, { 2, 20 }, { 2, 21 } }));
+	auto instruments(fsp::source(std::vector<join_instrument_type>{ { 1, "GOOG" },
+		{ 2, "AAPL" } }));
+	auto joined(fsp::sink(fsp::join([](const join_order_type &order) { return order.instrument; },
+		[&](const join_instrument_type &instrument) {
+			++keyed;
+			return instrument.id;
+		}, [](const join_order_type &order, const join_instrument_type &instrument) {
+			return instrument.symbol + ":" + std::to_string(order.quantity);
+		}, std::ref(orders), std::ref(instruments))));
+	ASSERT_EQ(keyed, 2);
+	orders = std::vector<join_order_type>{ { 1, 12 }, { 1, 13 }, { 2, 22 } };
+	ASSERT_EQ(keyed, 2);
+	ASSERT_EQ(to_vector(*joined), std::vector<std::string>({ "GOOG:12", "GOOG:13", "AAPL:22" }));
+	instruments = std::vector<join_instrument_type>{ { 1, "GOOGL" } };
+	ASSERT_EQ(keyed, 3);
+	ASSERT_EQ(to_vector(*joined), std::vector<std::string>({ "GOOGL:12", "GOOGL:13" }));
+}
+
+TEST(join, parallel) {
+	frp::priority_thread_pool_type pool(4, 1);
+	std::vector<join_order_type> input;
+	for (int i = 0; i < 40000; ++i) {
+		input.push_back({ i % 10000, i });
+	}
+	std::vector<join_instrument_type> listed;
+	for (int i = 0; i < 20000; i += 2) {
+		listed.push_back({ i, std::to_string(i) });
+	}
+	auto orders(fsp::source(std::move(input)));
+	auto instruments(fsp::source(std::move(listed)));
+	auto joined(fsp::sink(fsp::join([](const join_order_type &order) { return order.instrument; },
+		[](const join_instrument_type &instrument) { return instrument.id; },
+		frp::execute_on(pool.priority(0), [](const join_order_type &order,
+				const join_instrument_type &instrument) {
+			return order.quantity - instrument.id;
+		}), std::ref(orders), std::ref(instruments))));
+	pool.wait_idle();
+	auto reference(*joined);
+	ASSERT_EQ(reference->size(), 20000u);
+	for (std::size_t i = 0; i < reference->size(); ++i) {
+		ASSERT_EQ((*reference)[i] % 10000, 0);
+	}
+}
@@ -92,3 +92,15 @@ TEST(map, expanded_index) {
 	auto expected(make_array(1 + 3, 1 + 1 + 3, 1 + 2 * 2 + 3, 1 + 3 * 3 + 3));
 	ASSERT_TRUE(std::equal(std::begin(value), std::end(value), std::begin(expected)));
 }
+
+TEST(map, never_equal) {
+	auto source(frp::stat::push::source(make_array(1, 2, 3)));
+	int evaluations(0);
+	auto map(frp::stat::push::map<frp::never_equal>([](auto i) { return i % 2; },
+		std::ref(source)));
+	auto counter(frp::stat::push::transform([&](const auto &) { ++evaluations; },
+		std::ref(map)));
+	ASSERT_EQ(evaluations, 1);
+	source = { 3, 4, 5 };
+	ASSERT_EQ(evaluations, 2);
+}
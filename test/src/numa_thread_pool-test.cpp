@@ -0,0 +1,71 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/numa_thread_pool.h>
+#include <frp/static/push/map.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+TEST(numa_topology, parse_cpulist) {
+	ASSERT_EQ(frp::numa_topology_type::parse_cpulist("0-3,8,10-11\n"),
+		std::vector<unsigned>({ 0, 1, 2, 3, 8, 10, 11 }));
+	ASSERT_TRUE(frp::numa_topology_type::parse_cpulist("").empty());
+}
+
+TEST(numa_topology, detect) {
+	auto topology(frp::numa_topology_type::detect());
+	ASSERT_FALSE(topology.nodes.empty());
+	std::size_t cpus(0);
+	for (const auto &node : topology.nodes) {
+		cpus += node.size();
+	}
+	ASSERT_GT(cpus, 0);
+}
+
+TEST(numa_thread_pool, partitioned_map) {
+	frp::numa_thread_pool_type pool(frp::numa_topology_type::fake(4), 2);
+	ASSERT_EQ(pool.nodes(), 4);
+	ASSERT_EQ(pool.current_node(), frp::numa_thread_pool_type::no_node);
+	std::vector<int> values(100);
+	std::iota(values.begin(), values.end(), 0);
+	auto source(fsp::source(values));
+	auto nodes(fsp::sink(fsp::map(frp::execute_on(pool.executor(), [&](int value) {
+		return std::make_pair(value, pool.current_node());
+	}), std::ref(source))));
+	pool.wait_idle();
+	auto reference(*nodes);
+	ASSERT_EQ(reference->size(), values.size());
+	for (const auto &node : *reference) {
+		ASSERT_EQ(node.second, std::size_t(node.first) * 4 / values.size());
+	}
+}
+
+TEST(numa_thread_pool, local_node) {
+	frp::numa_thread_pool_type pool(frp::numa_topology_type::fake(2), 1);
+	auto executor(pool.executor());
+	std::vector<std::size_t> nodes(4, frp::numa_thread_pool_type::no_node);
+	for (std::size_t index = 0; index < 2; ++index) {
+		executor([&, index]() {
+			nodes[index] = pool.current_node();
+			executor([&, index]() {
+				nodes[index + 2] = pool.current_node();
+			});
+		});
+	}
+	pool.wait_idle();
+	ASSERT_NE(nodes[0], nodes[1]);
+	ASSERT_EQ(nodes[0], nodes[2]);
+	ASSERT_EQ(nodes[1], nodes[3]);
+}
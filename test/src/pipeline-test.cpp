@@ -0,0 +1,90 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <frp/static/push/pipeline.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <task_queue.h>
+#include <vector>
+
+namespace {
+
+template<typename Collection>
+std::vector<typename Collection::value_type> sorted(const Collection &collection) {
+	std::vector<typename Collection::value_type> values(collection.begin(), collection.end());
+	std::sort(values.begin(), values.end());
+	return values;
+}
+
+} // namespace
+
+TEST(pipeline, mapped) {
+	auto source(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto sink(fsp::sink(fsp::fuse(std::ref(source)
+		| fsp::mapped([](int i) { return i * 2; })
+		| fsp::mapped([](int i) { return std::to_string(i); }))));
+	auto reference(*sink);
+	ASSERT_EQ(std::vector<std::string>(reference->begin(), reference->end()),
+		(std::vector<std::string>{ "2", "4", "6" }));
+	source = std::vector<int>{ 4, 5 };
+	reference = *sink;
+	ASSERT_EQ(std::vector<std::string>(reference->begin(), reference->end()),
+		(std::vector<std::string>{ "8", "10" }));
+}
+
+TEST(pipeline, filtered) {
+	auto source(fsp::source(std::vector<int>{ 1, 2, 3, 4, 5, 6 }));
+	int calls(0);
+	auto sink(fsp::sink(fsp::fuse(std::ref(source)
+		| fsp::mapped([](int i) { return i * 3; })
+		| fsp::filtered([](int i) { return i % 2 == 0; })
+		| fsp::mapped([&](int i) { ++calls; return i + 1; }))));
+	auto reference(*sink);
+	ASSERT_EQ(sorted(*reference), (std::vector<int>{ 7, 13, 19 }));
+	ASSERT_EQ(calls, 3);
+	source = std::vector<int>{ 1, 3 };
+	ASSERT_TRUE((*sink)->empty());
+}
+
+TEST(pipeline, empty) {
+	auto source(fsp::source(std::vector<int>()));
+	auto sink(fsp::sink(fsp::fuse(std::ref(source)
+		| fsp::filtered([](int i) { return i > 0; }))));
+	ASSERT_TRUE((*sink)->empty());
+}
+
+TEST(pipeline, executor) {
+	task_queue queue;
+	auto source(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto sink(fsp::sink(fsp::fuse(frp::execute_on(std::ref(queue), std::ref(source)
+		| fsp::mapped([](int i) { return i * i; })))));
+	ASSERT_FALSE(*sink);
+	// One task per element runs every stage.
+	queue.process_all();
+	auto reference(*sink);
+	ASSERT_EQ(std::vector<int>(reference->begin(), reference->end()),
+		(std::vector<int>{ 1, 4, 9 }));
+}
+
+TEST(pipeline, movable) {
+	auto source(fsp::source(std::vector<int>{ 1, 2 }));
+	auto sink(fsp::sink(fsp::fuse(std::ref(source)
+		| fsp::mapped([](int i) { return std::make_unique<int>(i); })
+		| fsp::filtered([](const std::unique_ptr<int> &value) { return *value > 1; }))));
+	auto reference(*sink);
+	ASSERT_EQ(reference->size(), 1u);
+	ASSERT_EQ(**reference->begin(), 2);
+}
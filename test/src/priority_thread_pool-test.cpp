@@ -0,0 +1,147 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <frp/priority_thread_pool.h>
+#include <frp/static/push/filter.h>
+#include <frp/static/push/map.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/transform.h>
+#include <future>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(priority_thread_pool, strict_priority) {
+	frp::priority_thread_pool_type pool(1, 3);
+	std::promise<void> gate;
+	auto opened(gate.get_future().share());
+	pool.priority(0)([opened]() { opened.wait(); });
+	std::mutex mutex;
+	std::vector<int> order;
+	auto record([&](int value) {
+		return [&, value]() {
+			std::lock_guard<std::mutex> lock(mutex);
+			order.push_back(value);
+		};
+	});
+	pool.priority(2)(record(20));
+	pool.priority(1)(record(10));
+	pool.priority(2)(record(21));
+	pool.priority(0)(record(0));
+	pool.priority(1)(record(11));
+	gate.set_value();
+	pool.wait_idle();
+	ASSERT_EQ(order, std::vector<int>({ 0, 10, 11, 20, 21 }));
+}
+
+TEST(priority_thread_pool, map_does_not_starve_transform) {
+	frp::priority_thread_pool_type pool(1, 2);
+	auto low(pool.priority(1));
+	auto high(pool.priority(0));
+	std::atomic_int mapped(0);
+	std::atomic_int mapped_before_transform(-1);
+	auto elements(fsp::source(std::vector<int>(1000, 1)));
+	auto price(fsp::source(1));
+	auto batch(fsp::sink(fsp::map(frp::execute_on(low, [&](int i) {
+		++mapped;
+		return i;
+	}), std::ref(elements))));
+	auto quote(fsp::sink(fsp::transform(frp::execute_on(high, [&](int i) {
+		mapped_before_transform = mapped.load();
+		return i;
+	}), std::ref(price))));
+	pool.wait_idle();
+
+	std::promise<void> gate;
+	auto opened(gate.get_future().share());
+	high([opened]() { opened.wait(); });
+	elements = std::vector<int>(1000, 2);
+	price = 2;
+	gate.set_value();
+	pool.wait_idle();
+	ASSERT_EQ(mapped_before_transform, 1000);
+	ASSERT_EQ(**quote, 2);
+	ASSERT_EQ((*batch)->size(), 1000);
+	ASSERT_EQ(mapped, 2000);
+}
+
+TEST(inline_if_on, continues_on_worker) {
+	frp::priority_thread_pool_type pool(4, 1);
+	auto executor(frp::inline_if_on(pool.priority(0)));
+	ASSERT_FALSE(pool.priority(0).on_worker());
+	std::mutex mutex;
+	std::vector<std::thread::id> threads;
+	auto record([&](int i) {
+		std::lock_guard<std::mutex> lock(mutex);
+		threads.push_back(std::this_thread::get_id());
+		return i + 1;
+	});
+	auto source(fsp::source(0));
+	auto first(fsp::transform(frp::execute_on(executor, record), std::ref(source)));
+	auto second(fsp::transform(frp::execute_on(executor, record), std::ref(first)));
+	auto third(fsp::sink(fsp::transform(frp::execute_on(executor, record), std::ref(second))));
+	pool.wait_idle();
+	ASSERT_EQ(**third, 3);
+	threads.clear();
+	source = 1;
+	pool.wait_idle();
+	ASSERT_EQ(**third, 4);
+	ASSERT_EQ(threads.size(), 3);
+	ASSERT_NE(threads[0], std::this_thread::get_id());
+	ASSERT_EQ(threads[1], threads[0]);
+	ASSERT_EQ(threads[2], threads[0]);
+}
+
+TEST(inline_if_on, map_elements_are_submitted) {
+	frp::priority_thread_pool_type pool(2, 1);
+	auto executor(frp::inline_if_on(pool.priority(0)));
+	auto source(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto copied(fsp::transform(frp::execute_on(executor, [](const auto &values) {
+		return std::vector<int>(values.begin(), values.end());
+	}), std::ref(source)));
+	auto squares(fsp::sink(fsp::map(frp::execute_on(executor, [](int i) { return i * i; }),
+		std::ref(copied))));
+	pool.wait_idle();
+	auto reference(*squares);
+	ASSERT_EQ(std::vector<int>(reference->begin(), reference->end()),
+		std::vector<int>({ 1, 4, 9 }));
+}
+
+TEST(inline_if_on, filter_elements_are_submitted) {
+	frp::priority_thread_pool_type pool(2, 1);
+	auto executor(frp::inline_if_on(pool.priority(0)));
+	std::mutex mutex;
+	std::condition_variable condition;
+	int arrived(0);
+	auto source(fsp::source(std::vector<int>{ 1, 2 }));
+	auto copied(fsp::transform(frp::execute_on(executor, [](const auto &values) {
+		return std::vector<int>(values.begin(), values.end());
+	}), std::ref(source)));
+	// Both elements only pass if they run concurrently, rather than inline one after another.
+	auto filtered(fsp::sink(fsp::filter(frp::execute_on(executor, [&](int) {
+		std::unique_lock<std::mutex> lock(mutex);
+		++arrived;
+		condition.notify_all();
+		return condition.wait_for(lock, std::chrono::seconds(5), [&]() { return arrived >= 2; });
+	}), std::ref(copied))));
+	pool.wait_idle();
+	auto reference(*filtered);
+	std::vector<int> values(reference->begin(), reference->end());
+	std::sort(values.begin(), values.end());
+	ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+}
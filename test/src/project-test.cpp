@@ -0,0 +1,65 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/static/push/project.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/transform.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct quote_type {
+	std::string symbol;
+	double price;
+	std::vector<int> depth;
+
+	bool operator==(const quote_type &quote) const {
+		return symbol == quote.symbol && price == quote.price && depth == quote.depth;
+	}
+};
+
+} // namespace
+
+TEST(project, member) {
+	auto quote(fsp::source(quote_type{ "GOOG", 1.0, { 1, 2, 3 } }));
+	auto price(fsp::project(&quote_type::price, std::ref(quote)));
+	int evaluations(0);
+	auto doubled(fsp::sink(fsp::transform([&](double price) {
+		++evaluations;
+		return price * 2;
+	}, std::ref(price))));
+	ASSERT_EQ(**doubled, 2.0);
+	ASSERT_EQ(evaluations, 1);
+
+	quote.modify([](auto &quote) { quote.depth.push_back(4); });
+	ASSERT_EQ(evaluations, 1);
+	quote = quote_type{ "GOOGL", 1.0, {} };
+	ASSERT_EQ(evaluations, 1);
+	quote = quote_type{ "GOOGL", 2.0, {} };
+	ASSERT_EQ(evaluations, 2);
+	ASSERT_EQ(**doubled, 4.0);
+}
+
+TEST(project, borrowed) {
+	auto quote(fsp::source(quote_type{ "GOOG", 1.0, { 1, 2, 3 } }));
+	auto depth(fsp::sink(fsp::project(&quote_type::depth, std::ref(quote))));
+	auto reference(*depth);
+	const std::vector<int> &borrowed(*reference);
+	ASSERT_EQ(&borrowed, &(*quote)->depth);
+	// The projected value keeps the value it refers to alive.
+	quote = quote_type{ "GOOG", 1.0, { 4 } };
+	ASSERT_EQ(borrowed, (std::vector<int>{ 1, 2, 3 }));
+	ASSERT_EQ((*depth)->get(), (std::vector<int>{ 4 }));
+}
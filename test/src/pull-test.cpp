@@ -0,0 +1,101 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/static/pull/filter.h>
+#include <frp/static/pull/map.h>
+#include <frp/static/pull/sink.h>
+#include <frp/static/pull/source.h>
+#include <frp/static/pull/transform.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/transform.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(pull, lazy_transform) {
+	auto source(fspl::source(2));
+	int evaluations(0);
+	auto squared(fspl::transform([&](int i) { ++evaluations; return i * i; }, std::ref(source)));
+	ASSERT_EQ(evaluations, 0);
+	source = 3;
+	source = 4;
+	ASSERT_EQ(evaluations, 0);
+	auto sink(fspl::sink(std::ref(squared)));
+	ASSERT_EQ(evaluations, 0);
+	ASSERT_EQ(**sink, 16);
+	ASSERT_EQ(evaluations, 1);
+	ASSERT_EQ(**sink, 16);
+	ASSERT_EQ(evaluations, 1);
+	source = 5;
+	ASSERT_EQ(evaluations, 1);
+	ASSERT_EQ(**sink, 25);
+	ASSERT_EQ(evaluations, 2);
+}
+
+TEST(pull, clean_subgraph) {
+	auto left(fspl::source(1));
+	auto right(fspl::source(2));
+	int left_evaluations(0);
+	int right_evaluations(0);
+	auto left_negated(fspl::transform([&](int i) { ++left_evaluations; return -i; },
+		std::ref(left)));
+	auto right_negated(fspl::transform([&](int i) { ++right_evaluations; return -i; },
+		std::ref(right)));
+	auto sum(fspl::sink(fspl::transform([](int i, int j) { return i + j; },
+		std::ref(left_negated), std::ref(right_negated))));
+	ASSERT_EQ(**sum, -3);
+	left = 3;
+	ASSERT_EQ(**sum, -5);
+	ASSERT_EQ(left_evaluations, 2);
+	ASSERT_EQ(right_evaluations, 1);
+}
+
+TEST(pull, unchanged_revision) {
+	auto source(fspl::source(2));
+	int evaluations(0);
+	auto parity(fspl::transform([](int i) { return i % 2; }, std::ref(source)));
+	auto sink(fspl::sink(fspl::transform([&](int i) { ++evaluations; return i; },
+		std::ref(parity))));
+	ASSERT_EQ(**sink, 0);
+	auto revision((*sink).revision());
+	source = 4;
+	ASSERT_EQ(**sink, 0);
+	ASSERT_EQ((*sink).revision(), revision);
+	ASSERT_EQ(evaluations, 1);
+}
+
+TEST(pull, map_filter) {
+	auto source(fspl::source(std::vector<int>{ 1, 2, 3, 4 }));
+	auto sink(fspl::sink(fspl::map([](int i) { return i * i; },
+		fspl::filter([](int i) { return i % 2 == 0; }, std::ref(source)))));
+	auto reference(*sink);
+	ASSERT_EQ(std::vector<int>(reference->begin(), reference->end()), std::vector<int>({ 4, 16 }));
+	source = std::vector<int>{ 5, 6 };
+	reference = *sink;
+	ASSERT_EQ(std::vector<int>(reference->begin(), reference->end()), std::vector<int>({ 36 }));
+}
+
+TEST(pull, push_interop) {
+	auto source(fspl::source(1));
+	auto doubled(fspl::transform([](int i) { return i * 2; }, std::ref(source)));
+	auto sink(fsp::sink(fsp::transform([](int i) { return i + 1; }, std::ref(doubled))));
+	ASSERT_EQ(**sink, 3);
+	source = 2;
+	ASSERT_EQ(**sink, 5);
+}
+
+TEST(pull, unavailable) {
+	auto source(fspl::source<int>());
+	auto sink(fspl::sink(fspl::transform([](int i) { return i; }, std::ref(source))));
+	ASSERT_FALSE(*sink);
+	source = 1;
+	ASSERT_EQ(**sink, 1);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/static/push/sample.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/transform.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(sample, on_tick) {
+	auto clock(fsp::source(0));
+	auto value(fsp::source(1));
+	int evaluations(0);
+	auto sampled(fsp::sink(fsp::transform([&](int value) {
+		++evaluations;
+		return value * 2;
+	}, fsp::sample(std::ref(clock), std::ref(value)))));
+	ASSERT_EQ(**sampled, 2);
+	ASSERT_EQ(evaluations, 1);
+
+	value = 2;
+	value = 3;
+	ASSERT_EQ(**sampled, 2);
+	ASSERT_EQ(evaluations, 1);
+	clock = 1;
+	ASSERT_EQ(**sampled, 6);
+	ASSERT_EQ(evaluations, 2);
+}
+
+TEST(sample, unchanged) {
+	auto clock(fsp::source(0));
+	auto value(fsp::source(1));
+	int evaluations(0);
+	auto sampled(fsp::sink(fsp::transform([&](int value) {
+		++evaluations;
+		return value;
+	}, fsp::sample(std::ref(clock), std::ref(value)))));
+	clock = 1;
+	clock = 2;
+	ASSERT_EQ(evaluations, 1);
+}
+
+TEST(sample, suspended_dependency) {
+	auto clock(fsp::source(0));
+	auto value(fsp::source(1));
+	auto multiplied(fsp::transform([](int value) { return value * 10; }, std::ref(value)));
+	{
+		auto sink(fsp::sink(std::ref(multiplied)));
+	}
+	auto sampled(fsp::sink(fsp::sample(std::ref(clock), std::ref(multiplied))));
+	value = 2;
+	clock = 1;
+	ASSERT_EQ(**sampled, 20);
+}
+
+TEST(sample, shares_storage) {
+	auto clock(fsp::source(0));
+	auto values(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto sampled(fsp::sink(fsp::sample(std::ref(clock), std::ref(values))));
+	values = std::vector<int>{ 4, 5 };
+	clock = 1;
+	auto reference(*sampled);
+	ASSERT_EQ(&*reference, &**values);
+}
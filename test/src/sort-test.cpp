@@ -0,0 +1,97 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <frp/execute_on.h>
+#include <frp/priority_thread_pool.h>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/sort.h>
+#include <frp/static/push/source.h>
+#include <functional>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<int> random_values(std::size_t size, unsigned seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<int> distribution(0, 1000);
+	std::vector<int> values(size);
+	std::generate(values.begin(), values.end(), [&]() { return distribution(generator); });
+	return values;
+}
+
+template<typename Reference>
+std::vector<int> to_vector(const Reference &reference) {
+	return std::vector<int>(reference->begin(), reference->end());
+}
+
+} // namespace
+
+TEST(sort, small) {
+	auto values(fsp::source(std::vector<int>{ 3, 1, 2 }));
+	auto sorted(fsp::sink(fsp::sort(std::less<int>(), std::ref(values))));
+	ASSERT_EQ(to_vector(*sorted), std::vector<int>({ 1, 2, 3 }));
+	values = std::vector<int>{};
+	ASSERT_TRUE((*sorted)->empty());
+}
+
+TEST(sort, parallel) {
+	frp::priority_thread_pool_type pool(4, 1);
+	auto input(random_values(100000, 1));
+	auto values(fsp::source(std::vector<int>(input)));
+	auto sorted(fsp::sink(fsp::sort(frp::execute_on(pool.priority(0), std::greater<int>()),
+		std::ref(values))));
+	pool.wait_idle();
+	std::sort(input.begin(), input.end(), std::greater<int>());
+	ASSERT_EQ(to_vector(*sorted), input);
+}
+
+TEST(sort, dependencies) {
+	auto pivot(fsp::source(5));
+	auto values(fsp::source(std::vector<int>{ 1, 4, 6, 9 }));
+	auto sorted(fsp::sink(fsp::sort<1>([](int a, int b, int pivot) {
+		return std::abs(a - pivot) < std::abs(b - pivot);
+	}, std::ref(pivot), std::ref(values))));
+	ASSERT_EQ(to_vector(*sorted), std::vector<int>({ 4, 6, 1, 9 }));
+	pivot = 10;
+	ASSERT_EQ(to_vector(*sorted), std::vector<int>({ 9, 6, 4, 1 }));
+}
+
+TEST(incremental_sort, merges_changes) {
+	std::size_t comparisons(0);
+	auto input(random_values(1000, 2));
+	auto values(fsp::source(std::vector<int>(input)));
+	auto sorted(fsp::sink(fsp::incremental_sort([&](int a, int b) {
+		++comparisons;
+		return a < b;
+	}, std::ref(values))));
+	// A full sort takes O(n log n) comparisons.
+	ASSERT_GT(comparisons, 4 * input.size());
+	comparisons = 0;
+	input[10] = -1;
+	input[500] = 2000;
+	input.push_back(input[0]);
+	values = std::vector<int>(input);
+	// The merge takes O(changes log changes + n) comparisons.
+	ASSERT_LT(comparisons, 2 * input.size());
+	auto expected(input);
+	std::sort(expected.begin(), expected.end());
+	ASSERT_EQ(to_vector(*sorted), expected);
+
+	input.erase(input.begin() + 900, input.end());
+	values = std::vector<int>(input);
+	expected = input;
+	std::sort(expected.begin(), expected.end());
+	ASSERT_EQ(to_vector(*sorted), expected);
+}
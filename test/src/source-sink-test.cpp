@@ -10,10 +10,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <chrono>
 #include <frp/static/push/sink.h>
 #include <frp/static/push/source.h>
 #include <gtest/gtest.h>
 #include <test_types.h>
+#include <thread>
+#include <vector>
 
 TEST(source, immediate_value) {
 	auto source(frp::stat::push::source(5));
@@ -60,3 +63,72 @@ TEST(sink, movable_type) {
 	ASSERT_EQ(source_reference->value, 2);
 	ASSERT_EQ(sink_reference->value, 2);
 }
+
+TEST(source, modify_in_place) {
+	auto source(frp::stat::push::source(std::vector<int>{ 1, 2, 3 }));
+	const int *data((*source)->data());
+	source.modify([](auto &values) { values[0] = 4; });
+	auto reference(*source);
+	ASSERT_EQ(reference->data(), data);
+	ASSERT_EQ(*reference, std::vector<int>({ 4, 2, 3 }));
+}
+
+TEST(source, modify_copy_on_write) {
+	auto source(frp::stat::push::source(std::vector<int>{ 1, 2, 3 }));
+	auto sink(frp::stat::push::sink(std::ref(source)));
+	auto previous(*sink);
+	source.modify([](auto &values) { values.push_back(4); });
+	ASSERT_EQ(*previous, std::vector<int>({ 1, 2, 3 }));
+	ASSERT_EQ(**sink, std::vector<int>({ 1, 2, 3, 4 }));
+	ASSERT_NE(previous->data(), (*sink)->data());
+}
+
+TEST(source, modify_unchanged) {
+	auto source(frp::stat::push::source(5));
+	int updates(0);
+	auto callback(frp::util::add_callback(source, [&]() { ++updates; }));
+	source.modify([](auto &) { return false; });
+	ASSERT_EQ(updates, 0);
+	source.modify([](auto &value) { value = 5; });
+	ASSERT_EQ(updates, 1);
+	ASSERT_EQ(**source, 5);
+}
+
+TEST(source, modify_undefined) {
+	auto source(frp::stat::push::source<int>());
+	ASSERT_THROW(source.modify([](auto &) {}), std::domain_error);
+	source = 1;
+	source.modify([](auto &value) { ++value; });
+	ASSERT_EQ(**source, 2);
+}
+
+TEST(sink, wait_for_revision_timeout) {
+	auto source(frp::stat::push::source(1));
+	auto sink(frp::stat::push::sink(std::ref(source)));
+	auto revision((*sink).revision());
+	auto reference(sink.wait_for_revision(revision, std::chrono::milliseconds(1)));
+	ASSERT_EQ(reference.revision(), revision);
+	ASSERT_EQ(*reference, 1);
+}
+
+TEST(sink, wait_for_revision) {
+	auto source(frp::stat::push::source<int>());
+	auto sink(frp::stat::push::sink(std::ref(source)));
+	ASSERT_THROW((*sink).revision(), std::domain_error);
+	std::thread thread([&]() {
+		for (int i = 1; i <= 100; ++i) {
+			source = i;
+		}
+	});
+	frp::util::revision_type revision(frp::util::default_revision);
+	for (;;) {
+		auto reference(sink.wait_for_revision(revision, std::chrono::seconds(10)));
+		ASSERT_TRUE(reference);
+		ASSERT_GT(reference.revision(), revision);
+		revision = reference.revision();
+		if (*reference == 100) {
+			break;
+		}
+	}
+	thread.join();
+}
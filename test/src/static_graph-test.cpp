@@ -0,0 +1,90 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/static_graph.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+TEST(static_graph, propagate) {
+	int products(0), labels(0);
+	auto graph(frp::make_static_graph(
+		frp::graph::input<int>(2),
+		frp::graph::input<int>(3),
+		frp::graph::node<0, 1>([&](int a, int b) { ++products; return a * b; }),
+		frp::graph::node<2>([&](int product) { ++labels; return std::to_string(product); })));
+	static_assert(std::is_same<decltype(graph)::value_type<3>, std::string>::value,
+		"node value types are deduced from their functions");
+	ASSERT_EQ(graph.get<2>(), 6);
+	ASSERT_EQ(graph.get<3>(), "6");
+	ASSERT_EQ(products, 1);
+	ASSERT_EQ(labels, 1);
+
+	graph.set<0>(4);
+	ASSERT_EQ(graph.get<3>(), "12");
+	ASSERT_EQ(products, 2);
+	ASSERT_EQ(labels, 2);
+
+	// An unchanged input does not evaluate anything.
+	graph.set<1>(3);
+	ASSERT_EQ(products, 2);
+}
+
+TEST(static_graph, constant) {
+	auto graph(frp::make_static_graph(
+		frp::graph::input<int>(1),
+		frp::graph::node<>([] { return 5; }),
+		frp::graph::node<0, 1>([](int a, int b) { return a + b; })));
+	ASSERT_EQ(graph.get<1>(), 5);
+	graph.set<0>(2);
+	ASSERT_EQ(graph.get<2>(), 7);
+}
+
+TEST(static_graph, unchanged) {
+	int parities(0), labels(0);
+	auto graph(frp::make_static_graph(
+		frp::graph::input<int>(1),
+		frp::graph::node<0>([&](int i) { ++parities; return i % 2; }),
+		frp::graph::node<1>([&](int parity) { ++labels; return parity ? "odd" : "even"; })));
+	// An unchanged intermediate value stops the propagation.
+	graph.set<0>(3);
+	ASSERT_EQ(parities, 2);
+	ASSERT_EQ(labels, 1);
+	graph.set<0>(4);
+	ASSERT_EQ(std::string(graph.get<2>()), "even");
+	ASSERT_EQ(labels, 2);
+}
+
+TEST(static_graph, independent_branches) {
+	int left(0), right(0);
+	auto graph(frp::make_static_graph(
+		frp::graph::input<int>(),
+		frp::graph::input<int>(),
+		frp::graph::node<0>([&](int i) { ++left; return i + 1; }),
+		frp::graph::node<1>([&](int i) { ++right; return i - 1; }),
+		frp::graph::node<2, 3>([](int a, int b) { return a + b; })));
+	ASSERT_EQ(graph.get<4>(), 0);
+	graph.set<1>(10);
+	ASSERT_EQ(graph.get<4>(), 10);
+	ASSERT_EQ(left, 1);
+	ASSERT_EQ(right, 2);
+}
+
+TEST(static_graph, movable) {
+	auto graph(frp::make_static_graph(
+		frp::graph::input<int>(1),
+		frp::graph::node<0>([](int i) { return std::make_unique<int>(i); })));
+	ASSERT_EQ(*graph.get<1>(), 1);
+	graph.set<0>(2);
+	ASSERT_EQ(*graph.get<1>(), 2);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/static/push/sink.h>
+#include <frp/static/push/stream_source.h>
+#include <frp/static/push/transform.h>
+#include <frp/util/queue.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(bounded_queue, push_pop) {
+	frp::util::bounded_queue_type<std::unique_ptr<int>> queue(3);
+	ASSERT_EQ(queue.capacity(), 4);
+	for (int i = 0; i < 4; ++i) {
+		ASSERT_TRUE(queue.push(std::make_unique<int>(i)));
+	}
+	ASSERT_FALSE(queue.push(std::make_unique<int>(4)));
+	ASSERT_EQ(queue.size(), 4);
+	int value(-1);
+	ASSERT_TRUE(queue.pop([&](std::unique_ptr<int> &&pointer) { value = *pointer; }));
+	ASSERT_EQ(value, 0);
+	ASSERT_EQ(queue.consume([&](std::unique_ptr<int> &&pointer) { value = *pointer; }), 3);
+	ASSERT_EQ(value, 3);
+	ASSERT_FALSE(queue.pop([](std::unique_ptr<int> &&) {}));
+}
+
+TEST(stream_source, manual_drain) {
+	auto stream(fsp::stream_source<int>(16));
+	auto sink(fsp::sink(std::ref(stream)));
+	ASSERT_FALSE(*sink);
+	stream.push(1);
+	stream.push(2);
+	ASSERT_FALSE(*sink);
+	ASSERT_EQ(stream.pending(), 2);
+	ASSERT_EQ(stream.drain(), 2);
+	ASSERT_EQ(**sink, std::vector<int>({ 1, 2 }));
+	ASSERT_EQ(stream.drain(), 0);
+	stream.push(1);
+	stream.push(2);
+	stream.drain();
+	auto reference(*sink);
+	ASSERT_EQ(*reference, std::vector<int>({ 1, 2 }));
+}
+
+TEST(stream_source, size_drain) {
+	auto stream(fsp::stream_source<int>(16, fsp::size_drain(3)));
+	int batches(0);
+	auto counter(fsp::transform([&](const auto &batch) {
+		ASSERT_EQ(batch.size(), 3);
+		++batches;
+	}, std::ref(stream)));
+	for (int i = 0; i < 9; ++i) {
+		stream.push(i);
+	}
+	ASSERT_EQ(batches, 3);
+	ASSERT_EQ(stream.pending(), 0);
+}
+
+TEST(stream_source, period_drain) {
+	auto stream(fsp::stream_source<int>(16, fsp::period_drain(std::chrono::hours(1))));
+	auto sink(fsp::sink(std::ref(stream)));
+	stream.push(1);
+	ASSERT_EQ(**sink, std::vector<int>({ 1 }));
+	stream.push(2);
+	ASSERT_EQ(stream.pending(), 1);
+	ASSERT_EQ(**sink, std::vector<int>({ 1 }));
+}
+
+TEST(stream_source, full_queue) {
+	auto stream(fsp::stream_source<std::unique_ptr<int>>(4));
+	int total(0);
+	auto counter(fsp::transform([&](const auto &batch) {
+		total += int(batch.size());
+	}, std::ref(stream)));
+	for (int i = 0; i < 4; ++i) {
+		ASSERT_TRUE(stream.try_push(std::make_unique<int>(i)));
+	}
+	ASSERT_FALSE(stream.try_push(std::make_unique<int>(4)));
+	stream.push(std::make_unique<int>(4));
+	ASSERT_EQ(total, 4);
+	stream.drain();
+	ASSERT_EQ(total, 5);
+}
+
+TEST(stream_source, multiple_producers) {
+	auto stream(fsp::stream_source<int>(64, fsp::size_drain(16)));
+	std::atomic_int total(0);
+	auto counter(fsp::transform([&](const auto &batch) {
+		for (auto value : batch) {
+			total += value;
+		}
+	}, std::ref(stream)));
+	std::vector<std::thread> producers;
+	for (int i = 0; i < 4; ++i) {
+		producers.emplace_back([&]() {
+			for (int j = 0; j < 10000; ++j) {
+				stream.push(1);
+			}
+		});
+	}
+	for (auto &producer : producers) {
+		producer.join();
+	}
+	stream.drain();
+	ASSERT_EQ(total, 4 * 10000);
+}
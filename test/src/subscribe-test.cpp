@@ -0,0 +1,124 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <atomic>
+#include <frp/priority_thread_pool.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/subscribe.h>
+#include <frp/static/push/transform.h>
+#include <gtest/gtest.h>
+#include <task_queue.h>
+#include <thread>
+#include <vector>
+
+TEST(subscribe, every_revision) {
+	auto source(fsp::source(1));
+	std::vector<int> values;
+	auto subscription(fsp::subscribe([&](const auto &value) { values.push_back(value); },
+		std::ref(source)));
+	source = 2;
+	source = 2;
+	source = 3;
+	ASSERT_EQ(values, std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST(subscribe, unsubscribe) {
+	auto source(fsp::source<int>());
+	std::vector<int> values;
+	{
+		auto subscription(fsp::subscribe([&](const auto &value) { values.push_back(value); },
+			std::ref(source)));
+		ASSERT_TRUE(values.empty());
+		source = 1;
+	}
+	source = 2;
+	ASSERT_EQ(values, std::vector<int>({ 1 }));
+}
+
+TEST(subscribe, repository) {
+	auto source(fsp::source(1));
+	std::vector<int> values;
+	auto subscription(fsp::subscribe([&](const auto &value) { values.push_back(value); },
+		fsp::transform([](auto i) { return i * 2; }, std::ref(source))));
+	source = 2;
+	ASSERT_EQ(values, std::vector<int>({ 2, 4 }));
+}
+
+TEST(subscribe, executor) {
+	task_queue queue;
+	auto source(fsp::source(1));
+	std::vector<int> values;
+	auto subscription(fsp::subscribe(frp::execute_on(std::ref(queue),
+		[&](const auto &value) { values.push_back(value); }), std::ref(source)));
+	source = 2;
+	source = 3;
+	ASSERT_TRUE(values.empty());
+	queue.process_all();
+	ASSERT_EQ(values, std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST(subscribe, latest) {
+	task_queue queue;
+	auto source(fsp::source(1));
+	std::vector<int> values;
+	auto subscription(fsp::subscribe_latest(frp::execute_on(std::ref(queue),
+		[&](const auto &value) { values.push_back(value); }), std::ref(source)));
+	source = 2;
+	source = 3;
+	queue.process_all();
+	ASSERT_EQ(values, std::vector<int>({ 3 }));
+	source = 4;
+	queue.process_all();
+	ASSERT_EQ(values, std::vector<int>({ 3, 4 }));
+}
+
+TEST(subscribe, unsubscribe_queued) {
+	task_queue queue;
+	auto source(fsp::source(1));
+	std::vector<int> values;
+	{
+		auto subscription(fsp::subscribe(frp::execute_on(std::ref(queue),
+			[&](const auto &value) { values.push_back(value); }), std::ref(source)));
+		auto latest(fsp::subscribe_latest(frp::execute_on(std::ref(queue),
+			[&](const auto &value) { values.push_back(value); }), std::ref(source)));
+		source = 2;
+	}
+	queue.process_all();
+	ASSERT_TRUE(values.empty());
+}
+
+// Tasks run on several workers at once, deliveries must still be ordered and never overlap.
+TEST(subscribe, serialized) {
+	frp::priority_thread_pool_type pool(4, 1);
+	auto source(fsp::source(0));
+	std::atomic_int running(0);
+	std::atomic_bool overlapped(false);
+	std::vector<int> values;
+	auto subscription(fsp::subscribe(frp::execute_on(pool.priority(0), [&](int value) {
+		if (running++ > 0) {
+			overlapped = true;
+		}
+		values.push_back(value);
+		std::this_thread::yield();
+		--running;
+	}), std::ref(source)));
+	for (int i = 1; i <= 1000; ++i) {
+		source = i;
+	}
+	pool.wait_idle();
+	ASSERT_FALSE(overlapped);
+	ASSERT_FALSE(values.empty());
+	ASSERT_TRUE(std::is_sorted(values.begin(), values.end()));
+	ASSERT_EQ(std::adjacent_find(values.begin(), values.end()), values.end());
+	ASSERT_EQ(values.back(), 1000);
+}
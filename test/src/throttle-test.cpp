@@ -0,0 +1,181 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/throttle.h>
+#include <frp/static/push/transform.h>
+#include <frp/timer_wheel.h>
+#include <future>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef frp::timer_wheel_type<> manual_wheel_type;
+
+std::chrono::milliseconds operator"" _ms(unsigned long long value) {
+	return std::chrono::milliseconds(value);
+}
+
+} // namespace
+
+TEST(timer_wheel, order) {
+	auto origin(manual_wheel_type::clock_type::now());
+	manual_wheel_type wheel(1_ms, origin);
+	std::vector<int> fired;
+	wheel.schedule(origin + 300000_ms, [&]() { fired.push_back(3); });
+	wheel.schedule(origin + 70_ms, [&]() { fired.push_back(2); });
+	wheel.schedule(origin + 5_ms, [&]() { fired.push_back(1); });
+	ASSERT_EQ(wheel.size(), 3u);
+	wheel.advance(origin + 4_ms);
+	ASSERT_TRUE(fired.empty());
+	wheel.advance(origin + 5_ms);
+	ASSERT_EQ(fired, std::vector<int>({ 1 }));
+	wheel.advance(origin + 69_ms);
+	ASSERT_EQ(fired, std::vector<int>({ 1 }));
+	wheel.advance(origin + 70_ms);
+	ASSERT_EQ(fired, std::vector<int>({ 1, 2 }));
+	wheel.advance(origin + 299999_ms);
+	ASSERT_EQ(fired, std::vector<int>({ 1, 2 }));
+	wheel.advance(origin + 300000_ms);
+	ASSERT_EQ(fired, std::vector<int>({ 1, 2, 3 }));
+	ASSERT_EQ(wheel.size(), 0u);
+}
+
+TEST(timer_wheel, past_deadline) {
+	auto origin(manual_wheel_type::clock_type::now());
+	manual_wheel_type wheel(1_ms, origin);
+	wheel.advance(origin + 10_ms);
+	int fired(0);
+	wheel.schedule(origin, [&]() { ++fired; });
+	wheel.advance(origin + 10_ms);
+	ASSERT_EQ(fired, 0);
+	wheel.advance(origin + 11_ms);
+	ASSERT_EQ(fired, 1);
+}
+
+// The thread sleeps while no timers are pending and is woken by schedule.
+TEST(timer_wheel, started) {
+	manual_wheel_type wheel;
+	wheel.start();
+	std::this_thread::sleep_for(20_ms);
+	std::promise<void> near, far;
+	wheel.schedule(manual_wheel_type::clock_type::now() + 70_ms, [&]() { far.set_value(); });
+	wheel.schedule(manual_wheel_type::clock_type::now() + 5_ms, [&]() { near.set_value(); });
+	ASSERT_EQ(near.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+	ASSERT_EQ(far.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+	ASSERT_EQ(wheel.size(), 0u);
+	wheel.stop();
+}
+
+// Scheduling after a long idle stretch must not walk every elapsed tick.
+TEST(timer_wheel, started_after_idle) {
+	auto now(manual_wheel_type::clock_type::now());
+	manual_wheel_type wheel(1_ms, now - std::chrono::hours(24 * 30));
+	wheel.start();
+	std::promise<void> fired;
+	wheel.schedule(manual_wheel_type::clock_type::now() + 5_ms, [&]() { fired.set_value(); });
+	ASSERT_EQ(fired.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+	wheel.stop();
+}
+
+TEST(throttle, leading_and_trailing) {
+	auto origin(manual_wheel_type::clock_type::now());
+	manual_wheel_type wheel(1_ms, origin);
+	auto value(fsp::source(0));
+	int evaluations(0);
+	auto throttled(fsp::sink(fsp::transform([&](int value) {
+		++evaluations;
+		return value;
+	}, fsp::throttle(wheel, 10_ms, std::ref(value)))));
+	ASSERT_EQ(**throttled, 0);
+	ASSERT_EQ(evaluations, 1);
+
+	value = 1;
+	value = 2;
+	value = 3;
+	ASSERT_EQ(**throttled, 0);
+	ASSERT_EQ(evaluations, 1);
+	wheel.advance(origin + 9_ms);
+	ASSERT_EQ(**throttled, 0);
+	wheel.advance(origin + 10_ms);
+	ASSERT_EQ(**throttled, 3);
+	ASSERT_EQ(evaluations, 2);
+
+	wheel.advance(origin + 25_ms);
+	value = 4;
+	ASSERT_EQ(**throttled, 4);
+	ASSERT_EQ(evaluations, 3);
+}
+
+TEST(throttle, shares_storage) {
+	auto origin(manual_wheel_type::clock_type::now());
+	manual_wheel_type wheel(1_ms, origin);
+	auto values(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto throttled(fsp::sink(fsp::throttle(wheel, 10_ms, std::ref(values))));
+	auto reference(*throttled);
+	ASSERT_EQ(&*reference, &**values);
+}
+
+TEST(debounce, quiet) {
+	auto origin(manual_wheel_type::clock_type::now());
+	manual_wheel_type wheel(1_ms, origin);
+	auto value(fsp::source(0));
+	auto debounced(fsp::sink(fsp::debounce(wheel, 10_ms, std::ref(value))));
+	ASSERT_EQ(**debounced, 0);
+
+	value = 1;
+	wheel.advance(origin + 6_ms);
+	value = 2;
+	wheel.advance(origin + 10_ms);
+	ASSERT_EQ(**debounced, 0);
+	wheel.advance(origin + 15_ms);
+	ASSERT_EQ(**debounced, 0);
+	wheel.advance(origin + 16_ms);
+	ASSERT_EQ(**debounced, 2);
+}
+
+// The thread of a started wheel sleeps while idle, now() must still follow the clock.
+TEST(debounce, started) {
+	manual_wheel_type wheel;
+	wheel.start();
+	std::this_thread::sleep_for(200_ms);
+	auto value(fsp::source(0));
+	auto debounced(fsp::sink(fsp::debounce(wheel, 100_ms, std::ref(value))));
+	for (int i = 1; i <= 10; ++i) {
+		value = i;
+		std::this_thread::sleep_for(20_ms);
+		ASSERT_EQ(**debounced, 0);
+	}
+	auto deadline(manual_wheel_type::clock_type::now() + std::chrono::seconds(5));
+	while (**debounced != 10 && manual_wheel_type::clock_type::now() < deadline) {
+		std::this_thread::sleep_for(10_ms);
+	}
+	ASSERT_EQ(**debounced, 10);
+	wheel.stop();
+}
+
+TEST(debounce, released) {
+	auto origin(manual_wheel_type::clock_type::now());
+	manual_wheel_type wheel(1_ms, origin);
+	auto value(fsp::source(0));
+	{
+		auto debounced(fsp::debounce(wheel, 10_ms, std::ref(value)));
+		value = 1;
+	}
+	value = 2;
+	wheel.advance(origin + 20_ms);
+	ASSERT_EQ(wheel.size(), 0u);
+}
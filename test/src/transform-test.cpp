@@ -198,3 +198,42 @@ TEST(transform, references) {
 	auto source(frp::stat::push::transform([]() { return -2; }));
 	frp::stat::push::transform(std::cref(f), std::cref(source));
 }
+
+TEST(transform, never_equal) {
+	auto source(frp::stat::push::source<frp::never_equal>(1));
+	int evaluations(0);
+	auto transform(frp::stat::push::transform<frp::never_equal>([](auto i) { return i % 2; },
+		std::ref(source)));
+	auto counter(frp::stat::push::transform([&](auto) { ++evaluations; }, std::ref(transform)));
+	ASSERT_EQ(evaluations, 1);
+	source = 1;
+	ASSERT_EQ(evaluations, 2);
+	source = 3;
+	ASSERT_EQ(evaluations, 3);
+}
+
+TEST(transform, deep_chain) {
+	const int depth(100000);
+	auto source(fsp::source(0));
+	std::vector<fsp::repository_type<int>> chain;
+	chain.reserve(depth);
+	chain.push_back(fsp::transform([](int i) { return i + 1; }, std::ref(source)));
+	for (int i = 1; i < depth; ++i) {
+		chain.push_back(fsp::transform([](int i) { return i + 1; }, std::ref(chain.back())));
+	}
+	{
+		auto sink(fsp::sink(std::ref(chain.back())));
+		ASSERT_EQ(**sink, depth);
+		source = 1;
+		ASSERT_EQ(**sink, depth + 1);
+	}
+	source = 2;
+	{
+		auto sink(fsp::sink(std::ref(chain.back())));
+		ASSERT_EQ(**sink, depth + 2);
+	}
+	// Dependents must be destroyed before their dependencies.
+	while (!chain.empty()) {
+		chain.pop_back();
+	}
+}
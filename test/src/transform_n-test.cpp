@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/subscribe.h>
+#include <frp/static/push/transform.h>
+#include <frp/static/push/transform_n.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <tuple>
+
+TEST(transform_n, outputs) {
+	auto source(fsp::source(7));
+	int evaluations(0);
+	auto outputs(fsp::transform_n([&](int i) {
+		++evaluations;
+		return std::make_tuple(i / 2, i % 2, std::to_string(i));
+	}, std::ref(source)));
+	auto half(fsp::sink(std::ref(std::get<0>(outputs))));
+	auto parity(fsp::sink(std::ref(std::get<1>(outputs))));
+	auto text(fsp::sink(std::ref(std::get<2>(outputs))));
+	ASSERT_EQ(evaluations, 1);
+	ASSERT_EQ(**half, 3);
+	ASSERT_EQ(**parity, 1);
+	ASSERT_EQ(**text, "7");
+	source = 10;
+	ASSERT_EQ(evaluations, 2);
+	ASSERT_EQ(**half, 5);
+	ASSERT_EQ(**parity, 0);
+	ASSERT_EQ(**text, "10");
+}
+
+TEST(transform_n, unchanged_output) {
+	auto source(fsp::source(1));
+	auto outputs(fsp::transform_n([](int i) {
+		return std::make_tuple(i, i % 2);
+	}, std::ref(source)));
+	int values(0), parities(0);
+	auto value(fsp::transform([&](int i) { ++values; return i; },
+		std::ref(std::get<0>(outputs))));
+	auto parity(fsp::transform([&](int i) { ++parities; return i; },
+		std::ref(std::get<1>(outputs))));
+	source = 3;
+	ASSERT_EQ(values, 2);
+	ASSERT_EQ(parities, 1);
+	source = 4;
+	ASSERT_EQ(values, 3);
+	ASSERT_EQ(parities, 2);
+}
+
+TEST(transform_n, no_copies) {
+	auto source(fsp::source(2));
+	auto outputs(fsp::transform_n([](int i) {
+		return std::make_tuple(std::make_unique<int>(i), i);
+	}, std::ref(source)));
+	auto pointer(fsp::sink(std::ref(std::get<0>(outputs))));
+	const int *address((*pointer)->get());
+	ASSERT_EQ(**(*pointer), 2);
+	// The shared evaluation stays alive as long as any output does.
+	std::get<1>(outputs) = {};
+	source = 3;
+	ASSERT_EQ(**(*pointer), 3);
+	ASSERT_NE((*pointer)->get(), address);
+}
+
+TEST(transform_n, comparators) {
+	auto source(fsp::source(1));
+	auto outputs(fsp::transform_n<std::tuple<frp::never_equal, std::equal_to<int>>>([](int) {
+		return std::make_tuple(0, 0);
+	}, std::ref(source)));
+	int first(0), second(0);
+	auto a(fsp::transform([&](int) { return ++first; }, std::ref(std::get<0>(outputs))));
+	auto b(fsp::transform([&](int) { return ++second; }, std::ref(std::get<1>(outputs))));
+	source = 2;
+	ASSERT_EQ(first, 2);
+	ASSERT_EQ(second, 1);
+}
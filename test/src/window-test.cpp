@@ -0,0 +1,154 @@
+/*
+ * Copyright 2016 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <chrono>
+#include <frp/static/push/sink.h>
+#include <frp/static/push/source.h>
+#include <frp/static/push/stream_source.h>
+#include <frp/static/push/window.h>
+#include <frp/util/window.h>
+#include <frp/window.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock::time_point window_time_type;
+
+struct trade_type {
+	window_time_type time;
+	double price;
+	double quantity;
+
+	bool operator==(const trade_type &trade) const {
+		return time == trade.time && price == trade.price && quantity == trade.quantity;
+	}
+};
+
+struct vwap_type {
+	double notional;
+	double quantity;
+
+	bool operator==(const vwap_type &vwap) const {
+		return notional == vwap.notional && quantity == vwap.quantity;
+	}
+};
+
+window_time_type at(int milliseconds) {
+	return window_time_type(std::chrono::milliseconds(milliseconds));
+}
+
+auto max_aggregate() {
+	return frp::window::aggregate([](int value) { return value; },
+		[](int a, int b) { return std::max(a, b); });
+}
+
+} // namespace
+
+TEST(window, two_stack) {
+	frp::util::two_stack_window_type<int, decltype(max_aggregate())> window(max_aggregate());
+	window.push(3);
+	window.push(1);
+	ASSERT_EQ(window.get(), 3);
+	window.pop();
+	ASSERT_EQ(window.get(), 1);
+	window.push(2);
+	window.push(0);
+	ASSERT_EQ(window.get(), 2);
+	window.pop();
+	ASSERT_EQ(window.get(), 2);
+	window.pop();
+	ASSERT_EQ(window.get(), 0);
+	ASSERT_EQ(window.size(), 1u);
+}
+
+TEST(window, ring_buffer) {
+	frp::util::ring_buffer_type<int> buffer;
+	for (int i = 0; i < 20; ++i) {
+		buffer.push_back(int(i));
+		if (i % 2) {
+			ASSERT_EQ(buffer.pop_front(), i / 2);
+		}
+	}
+	ASSERT_EQ(buffer.size(), 10u);
+	ASSERT_EQ(buffer.front(), 10);
+}
+
+TEST(sliding_window, count) {
+	auto values(fsp::source(std::vector<int>{ 1, 2, 3 }));
+	auto sum(fsp::sink(fsp::sliding_window(2, frp::window::sum([](int value) {
+		return value;
+	}), std::ref(values))));
+	ASSERT_EQ(**sum, 5);
+	values = std::vector<int>{ 4 };
+	ASSERT_EQ(**sum, 7);
+	values = std::vector<int>{ 10, 20, 30 };
+	ASSERT_EQ(**sum, 50);
+}
+
+TEST(sliding_window, maximum) {
+	auto stream(fsp::stream_source<int>(16));
+	auto maximum(fsp::sink(fsp::sliding_window(3, max_aggregate(), std::ref(stream))));
+	std::vector<int> expected{ 5, 5, 5, 4, 3, 7 };
+	int index(0);
+	for (int value : { 5, 4, 3, 2, 1, 7 }) {
+		stream.push(int(value));
+		stream.drain();
+		ASSERT_EQ(**maximum, expected[index++]);
+	}
+}
+
+TEST(sliding_window, time) {
+	auto trades(fsp::source(std::vector<trade_type>{ { at(0), 10, 1 }, { at(5), 20, 3 } }));
+	auto vwap(fsp::sink(fsp::sliding_window(std::chrono::milliseconds(10),
+		[](const trade_type &trade) { return trade.time; },
+		frp::window::aggregate([](const trade_type &trade) {
+			return vwap_type{ trade.price * trade.quantity, trade.quantity };
+		}, [](const vwap_type &a, const vwap_type &b) {
+			return vwap_type{ a.notional + b.notional, a.quantity + b.quantity };
+		}, [](const vwap_type &a, const vwap_type &b) {
+			return vwap_type{ a.notional - b.notional, a.quantity - b.quantity };
+		}), std::ref(trades))));
+	ASSERT_EQ((**vwap).notional / (**vwap).quantity, 17.5);
+	trades = std::vector<trade_type>{ { at(10), 30, 1 } };
+	ASSERT_EQ((**vwap).notional / (**vwap).quantity, 22.5);
+	trades = std::vector<trade_type>{ { at(100), 40, 2 } };
+	ASSERT_EQ((**vwap).notional / (**vwap).quantity, 40.0);
+}
+
+TEST(tumbling_window, count) {
+	auto values(fsp::source(std::vector<int>{ 1, 2 }));
+	auto sum(fsp::sink(fsp::tumbling_window(3, frp::window::sum([](int value) {
+		return value;
+	}), std::ref(values))));
+	ASSERT_FALSE(*sum);
+	values = std::vector<int>{ 3, 4 };
+	ASSERT_EQ(**sum, 6);
+	values = std::vector<int>{ 5, 6, 7, 8 };
+	ASSERT_EQ(**sum, 15);
+	values = std::vector<int>{ 10 };
+	ASSERT_EQ(**sum, 25);
+}
+
+TEST(tumbling_window, time) {
+	auto trades(fsp::source(std::vector<trade_type>{ { at(1), 10, 1 }, { at(9), 20, 1 } }));
+	auto volume(fsp::sink(fsp::tumbling_window(std::chrono::milliseconds(10),
+		[](const trade_type &trade) { return trade.time; },
+		frp::window::sum([](const trade_type &trade) { return trade.quantity; }),
+		std::ref(trades))));
+	ASSERT_FALSE(*volume);
+	trades = std::vector<trade_type>{ { at(10), 10, 4 }, { at(15), 10, 1 } };
+	ASSERT_EQ(**volume, 2.0);
+	trades = std::vector<trade_type>{ { at(35), 10, 1 } };
+	ASSERT_EQ(**volume, 5.0);
+}